@@ -0,0 +1,275 @@
+#!/usr/bin/env python3
+
+# Compile-time benchmarks for the reflection headers.
+#
+# Generates synthetic translation units of increasing size for each scenario below, compiles each of them,
+#   and reports the wall time, the peak memory usage of the compiler, and (with Clang) the number of template instantiations from `-ftime-trace`.
+# The scenarios with the `_preprocess` suffix only run the preprocessor (`-E`).
+# The `_import` scenarios use `import em.refl;` instead of the headers (Clang only). The BMI is built once from `include/em/refl/module.cppm` before them,
+#   and its build time is reported separately. Compare them with the matching `_include` scenarios.
+# For every size after the first one, we also print the growth exponent of the time relative to the previous size,
+#   which is close to 1 if the cost is linear in `n`, and close to 2 if it's quadratic.
+#
+# Usage:
+#     bench/compile_time.py -- clang++ -std=c++23 -Iinclude -I<path to em/meta and em/macros> [more flags...]
+#
+# Use `--save FILE` to store the results as JSON, and `--compare FILE` to compare against such a file,
+#   in which case the script exits with a non-zero status if anything got slower than the `--tolerance`.
+
+import argparse
+import json
+import math
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+
+# --- Scenarios. Each returns the source code for the size `n`.
+
+def gen_struct_members(n):
+    # `n` structs with `n` members each, and one `VisitMembers()` call per struct.
+    out = ['#include "em/refl/macros/structs.h"', '#include "em/refl/visit_members.h"', '']
+    for i in range(n):
+        out.append(f'EM_STRUCT(S{i})')
+        out.append('(')
+        for j in range(n):
+            out.append(f'    (int)(m{j})')
+        out.append(')')
+    out.append('int foo()')
+    out.append('{')
+    out.append('    int ret = 0;')
+    for i in range(n):
+        out.append(f'    em::Refl::VisitMembers<em::Meta::LoopSimple>(S{i}{{}}, [&]<em::Refl::VisitDesc>(int x){{ret += x;}});')
+    out.append('    return ret;')
+    out.append('}')
+    return '\n'.join(out)
+
+def gen_wide_struct(n):
+    # A single struct with `n` members, with every member accessed by index.
+    out = ['#include "em/refl/macros/structs.h"', '#include "em/refl/access/structs.h"', '']
+    out.append('EM_STRUCT(S)')
+    out.append('(')
+    for j in range(n):
+        out.append(f'    (int)(m{j})')
+    out.append(')')
+    out.append('int foo(const S &s)')
+    out.append('{')
+    out.append('    return ' + ' + '.join(f'em::Refl::Structs::GetMemberConst<{j}>(s)' for j in range(n)) + ';')
+    out.append('}')
+    return '\n'.join(out)
+
+def gen_wide_struct_minimize_padding(n):
+    # Same as `gen_wide_struct()`, but with `EM_MINIMIZE_PADDING`, and the member types vary so the reordering actually does something.
+    types = ['char', 'double', 'short', 'int']
+    out = ['#include "em/refl/macros/structs.h"', '#include "em/refl/access/structs.h"', '#include "em/refl/minimize_padding.h"', '']
+    out.append('EM_STRUCT(S)')
+    out.append('(')
+    out.append('    EM_MINIMIZE_PADDING')
+    for j in range(n):
+        out.append(f'    ({types[j % len(types)]})(m{j})')
+    out.append(')')
+    out.append('double foo(const S &s)')
+    out.append('{')
+    out.append('    return ' + ' + '.join(f'em::Refl::Structs::GetMemberConst<{j}>(s)' for j in range(n)) + ';')
+    out.append('}')
+    return '\n'.join(out)
+
+def gen_visit_elems(n, use_module):
+    # `n` small structs, each visited with `RecursivelyVisitElemsOfTypeCvref`. This is mostly the cost of parsing the headers.
+    if use_module:
+        out = ['#include "em/refl/macros.h"', '', 'import em.refl;', '']
+    else:
+        out = ['#include "em/refl/macros/structs.h"', '#include "em/refl/recursively_visit_elems.h"', '']
+    for i in range(n):
+        out.append(f'EM_STRUCT(S{i})((int)(x)(float)(y))')
+        out.append(f'void foo{i}(S{i} &s) {{em::Refl::RecursivelyVisitElemsOfTypeCvref<float &>(s, [](float &x){{x++;}});}}')
+    return '\n'.join(out)
+
+def gen_deep_nesting(n):
+    # A chain of `n` nested structs, queried with `TypeRecursivelyContainsElemCvref` and `RecursivelyVisitElemsOfTypeCvref`.
+    out = ['#include "em/refl/macros/structs.h"', '#include "em/refl/recursively_visit_elems.h"', '', '#include <vector>', '']
+    out.append('EM_STRUCT(S0)((int)(x))')
+    for i in range(1, n):
+        out.append(f'EM_STRUCT(S{i})((S{i-1})(a)(std::vector<S{i-1}>)(b)(float)(c))')
+    out.append(f'static_assert(em::Refl::TypeRecursivelyContainsElemCvref<S{n-1} &, int &>);')
+    out.append(f'static_assert(!em::Refl::TypeRecursivelyContainsElemCvref<S{n-1} &, double &>);')
+    out.append(f'void foo(S{n-1} &s) {{em::Refl::RecursivelyVisitElemsOfTypeCvref<int &>(s, [](int &x){{x++;}});}}')
+    return '\n'.join(out)
+
+def gen_wide_variant(n):
+    # A variant with `n` distinct alternatives, visited recursively.
+    out = ['#include "em/refl/macros/structs.h"', '#include "em/refl/recursively_visit_elems.h"', '', '#include <variant>', '']
+    for i in range(n):
+        out.append(f'EM_STRUCT(A{i})((int)(x)(float)(y))')
+    out.append('using V = std::variant<' + ', '.join(f'A{i}' for i in range(n)) + '>;')
+    out.append('void foo(V &v) {em::Refl::RecursivelyVisitElemsOfTypeCvref<float &>(v, [](float &x){x++;});}')
+    return '\n'.join(out)
+
+def gen_static_virtual(n):
+    # An `EM_STATIC_VIRTUAL` base with `n` derived classes.
+    out = ['#include "em/refl/static_virtual.h"', '']
+    out.append('struct Base')
+    out.append('{')
+    out.append('    EM_REFL(')
+    out.append('        EM_STATIC_VIRTUAL(Iface, std::derived_from<_em_Derived, _em_Self>)')
+    out.append('        (')
+    out.append('            (Size, () -> std::size_t)(return sizeof(_em_Derived);)')
+    out.append('        )')
+    out.append('    )')
+    out.append('};')
+    for i in range(n):
+        out.append(f'struct D{i} : Base {{EM_REFL((int)(x{i}))}};')
+    return '\n'.join(out)
+
+# The values are `(generator, sizes, mode)`, where `mode` is one of: `compile`, `preprocess` (only run the preprocessor), `import` (needs the BMI of `em.refl`).
+SCENARIOS = {
+    'struct_members': (gen_struct_members, [5, 10, 20, 40], 'compile'),
+    'wide_struct': (gen_wide_struct, [25, 50, 100, 200, 400], 'compile'),
+    'wide_struct_preprocess': (gen_wide_struct, [25, 50, 100, 200, 400], 'preprocess'),
+    'wide_struct_minimize_padding': (gen_wide_struct_minimize_padding, [25, 50, 100, 200], 'compile'),
+    'deep_nesting': (gen_deep_nesting, [5, 10, 20, 40], 'compile'),
+    'wide_variant': (gen_wide_variant, [8, 16, 32, 64], 'compile'),
+    'static_virtual': (gen_static_virtual, [10, 50, 100, 200], 'compile'),
+    'visit_elems_include': (lambda n: gen_visit_elems(n, False), [1, 10, 50], 'compile'),
+    'visit_elems_import': (lambda n: gen_visit_elems(n, True), [1, 10, 50], 'import'),
+}
+
+MODULE_INTERFACE = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'include', 'em', 'refl', 'module.cppm')
+
+
+# --- Measuring.
+
+def count_instantiations(trace_path):
+    # Counts the template instantiation events in a Clang `-ftime-trace` file.
+    try:
+        with open(trace_path) as f:
+            events = json.load(f).get('traceEvents', [])
+    except (OSError, ValueError):
+        return None
+    return sum(1 for e in events if e.get('name') in ('InstantiateClass', 'InstantiateFunction'))
+
+def is_clang(compiler_cmd):
+    return 'clang' in os.path.basename(compiler_cmd[0])
+
+def run_compiler(cmd):
+    # Returns `(exit code, output, seconds, peak KiB)`.
+    # Redirect the output to files instead of pipes, so we can reap the compiler with `wait4()` ourselves and get its own peak memory usage.
+    with tempfile.TemporaryFile('w+') as log:
+        start = time.perf_counter()
+        proc = subprocess.Popen(cmd, stdout=log, stderr=subprocess.STDOUT)
+        _, status, usage = os.wait4(proc.pid, 0)
+        elapsed = time.perf_counter() - start
+        log.seek(0)
+        return os.waitstatus_to_exitcode(status), log.read(), elapsed, usage.ru_maxrss # Kilobytes on Linux.
+
+def build_module(compiler_cmd, tmp_dir):
+    # Builds the BMI of `em.refl`. Returns the extra flags to import it, or None on failure.
+    pcm_path = os.path.join(tmp_dir, 'em.refl.pcm')
+    cmd = compiler_cmd + ['--precompile', MODULE_INTERFACE, '-o', pcm_path]
+    returncode, output, elapsed, _ = run_compiler(cmd)
+    if returncode != 0:
+        sys.stderr.write(f'Building the BMI failed:\n{" ".join(cmd)}\n{output}\n')
+        return None
+    print(f'{"(module BMI)":<30} {elapsed:>8.3f} s', flush=True)
+    return [f'-fmodule-file=em.refl={pcm_path}']
+
+def measure(compiler_cmd, source, tmp_dir, name, mode, module_flags):
+    src_path = os.path.join(tmp_dir, name + '.cpp')
+    obj_path = os.path.join(tmp_dir, name + ('.i' if mode == 'preprocess' else '.o'))
+    with open(src_path, 'w') as f:
+        f.write(source)
+
+    # There are no template instantiations to count when only preprocessing.
+    trace = is_clang(compiler_cmd) and mode != 'preprocess'
+    cmd = compiler_cmd + (module_flags if mode == 'import' else []) + ['-E' if mode == 'preprocess' else '-c', src_path, '-o', obj_path] + (['-ftime-trace'] if trace else [])
+
+    returncode, output, elapsed, peak_kib = run_compiler(cmd)
+
+    if returncode != 0:
+        sys.stderr.write(f'Compilation of `{name}` failed:\n{" ".join(cmd)}\n{output}\n')
+        return None
+
+    return {
+        'seconds': round(elapsed, 3),
+        'peak_mib': round(peak_kib / 1024, 1),
+        'instantiations': count_instantiations(os.path.join(tmp_dir, name + '.json')) if trace else None,
+    }
+
+
+def growth_exponent(prev, cur):
+    # Given two `(n, seconds)` pairs, returns `k` such that the time grows as `n^k` between them.
+    if prev is None or prev[1] <= 0 or cur[1] <= 0:
+        return None
+    return math.log(cur[1] / prev[1]) / math.log(cur[0] / prev[0])
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compile-time benchmarks for the reflection headers.')
+    parser.add_argument('--scenario', action='append', choices=sorted(SCENARIOS), help='Only run those scenarios. Can be repeated.')
+    parser.add_argument('--save', metavar='FILE', help='Save the results to this JSON file.')
+    parser.add_argument('--compare', metavar='FILE', help='Compare against the results previously saved to this JSON file.')
+    parser.add_argument('--tolerance', type=float, default=0.15, help='Allowed relative slowdown when comparing, default 0.15.')
+    parser.add_argument('--print-source', metavar='SCENARIO:N', help='Print the generated source for this scenario and size, and exit.')
+    parser.add_argument('compiler', nargs=argparse.REMAINDER, help='The compiler command with flags, after `--`.')
+    args = parser.parse_args()
+
+    if args.print_source:
+        scenario, n = args.print_source.split(':')
+        print(SCENARIOS[scenario][0](int(n)))
+        return 0
+
+    compiler_cmd = [x for x in args.compiler if x != '--']
+    if not compiler_cmd:
+        parser.error('Specify the compiler command after `--`.')
+
+    results = {}
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        module_flags = None
+        for scenario in args.scenario or sorted(SCENARIOS):
+            gen, sizes, mode = SCENARIOS[scenario]
+            if mode == 'import' and module_flags is None:
+                if not is_clang(compiler_cmd):
+                    print(f'{scenario:<30} skipped, only supported with Clang', flush=True)
+                    continue
+                module_flags = build_module(compiler_cmd, tmp_dir)
+                if module_flags is None:
+                    return 1
+            prev = None
+            for n in sizes:
+                key = f'{scenario}:{n}'
+                result = measure(compiler_cmd, gen(n), tmp_dir, f'{scenario}_{n}', mode, module_flags)
+                if result is None:
+                    return 1
+                results[key] = result
+                inst = result['instantiations']
+                growth = growth_exponent(prev, (n, result['seconds']))
+                prev = (n, result['seconds'])
+                print(f'{key:<30} {result["seconds"]:>8.3f} s {result["peak_mib"]:>9.1f} MiB' + (f' {inst:>8} instantiations' if inst is not None else '') + (f'  (growth ~n^{growth:.2f})' if growth is not None else ''), flush=True)
+
+    if args.save:
+        with open(args.save, 'w') as f:
+            json.dump(results, f, indent=4)
+
+    if args.compare:
+        with open(args.compare) as f:
+            baseline = json.load(f)
+        regressions = []
+        for key, result in results.items():
+            old = baseline.get(key)
+            if not old:
+                continue
+            for metric in ('seconds', 'instantiations'):
+                if old.get(metric) and result.get(metric) is not None and result[metric] > old[metric] * (1 + args.tolerance):
+                    regressions.append(f'{key} {metric}: {old[metric]} -> {result[metric]}')
+        if regressions:
+            print('Regressions:\n    ' + '\n    '.join(regressions))
+            return 1
+        print('No regressions.')
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
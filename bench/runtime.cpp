@@ -0,0 +1,318 @@
+// Runtime benchmarks for the visiting functions, compared against the hand-written equivalents.
+// Each benchmark is a pair of non-inline functions, `Bench::<name>_refl()` and `Bench::<name>_manual()`, that compute the same checksum.
+// The program prints the time per element of both, and fails if the checksums differ.
+//
+// Build with optimizations, e.g. `clang++ -std=c++23 -O2 -Iinclude -I<path to em/meta and em/macros> bench/runtime.cpp -o runtime`,
+//   or use `bench/runtime.py`, which does that and also reports the code size of every benchmark function.
+
+#include "em/refl/macros/structs.h"
+#include "em/refl/recursively_visit_elems.h"
+#include "em/refl/recursively_visit_elems_static.h"
+#include "em/refl/visit_members.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+EM_STRUCT(Flat)
+(
+    (int)(a)
+    (int)(b)
+    (int)(c)
+    (int)(d)
+    (float)(e)
+    (float)(f)
+)
+
+EM_STRUCT(Inner)
+(
+    (int)(x)
+    (std::vector<int>)(values)
+)
+
+EM_STRUCT(Outer)
+(
+    (int)(id)
+    (std::vector<Inner>)(inners)
+)
+
+EM_STRUCT(WithOptionals)
+(
+    (std::optional<int>)(a)
+    (std::optional<Flat>)(b)
+)
+
+using Alternatives = std::variant<int, Flat, std::string>;
+
+struct Statics
+{
+    EM_REFL(
+        (int)(static s0)
+        (int)(static s1)
+        (int)(static s2)
+        (int)(static s3)
+        (int)(static s4)
+        (int)(static s5)
+        (int)(static s6)
+        (int)(static s7)
+    )
+};
+
+namespace Bench
+{
+    // --- Flat structs, non-recursive `VisitMembers()`.
+
+    [[gnu::noinline]] long long flat_visit_members_refl(const std::vector<Flat> &data)
+    {
+        long long ret = 0;
+        for (const Flat &elem : data)
+        {
+            em::Refl::VisitMembers<em::Meta::LoopSimple>(elem, [&]<em::Refl::VisitDesc>(const auto &member)
+            {
+                if constexpr (std::is_same_v<std::remove_cvref_t<decltype(member)>, int>)
+                    ret += member;
+            });
+        }
+        return ret;
+    }
+
+    [[gnu::noinline]] long long flat_visit_members_manual(const std::vector<Flat> &data)
+    {
+        long long ret = 0;
+        for (const Flat &elem : data)
+            ret += elem.a + elem.b + elem.c + elem.d;
+        return ret;
+    }
+
+    // --- Flat structs, recursive.
+
+    [[gnu::noinline]] long long flat_recursive_refl(const std::vector<Flat> &data)
+    {
+        long long ret = 0;
+        em::Refl::RecursivelyVisitElemsOfTypeCvref<const int &>(data, [&](const int &x){ret += x;});
+        return ret;
+    }
+
+    [[gnu::noinline]] long long flat_recursive_manual(const std::vector<Flat> &data)
+    {
+        return flat_visit_members_manual(data);
+    }
+
+    // --- Nested vectors.
+
+    [[gnu::noinline]] long long nested_refl(const std::vector<Outer> &data)
+    {
+        long long ret = 0;
+        em::Refl::RecursivelyVisitElemsOfTypeCvref<const int &>(data, [&](const int &x){ret += x;});
+        return ret;
+    }
+
+    [[gnu::noinline]] long long nested_manual(const std::vector<Outer> &data)
+    {
+        long long ret = 0;
+        for (const Outer &outer : data)
+        {
+            ret += outer.id;
+            for (const Inner &inner : outer.inners)
+            {
+                ret += inner.x;
+                for (int value : inner.values)
+                    ret += value;
+            }
+        }
+        return ret;
+    }
+
+    // --- Optionals, through `Indirect`.
+
+    [[gnu::noinline]] long long optionals_refl(const std::vector<WithOptionals> &data)
+    {
+        long long ret = 0;
+        em::Refl::RecursivelyVisitElemsOfTypeCvref<const int &>(data, [&](const int &x){ret += x;});
+        return ret;
+    }
+
+    [[gnu::noinline]] long long optionals_manual(const std::vector<WithOptionals> &data)
+    {
+        long long ret = 0;
+        for (const WithOptionals &elem : data)
+        {
+            if (elem.a)
+                ret += *elem.a;
+            if (elem.b)
+                ret += elem.b->a + elem.b->b + elem.b->c + elem.b->d;
+        }
+        return ret;
+    }
+
+    // --- Variants.
+
+    [[gnu::noinline]] long long variants_refl(const std::vector<Alternatives> &data)
+    {
+        long long ret = 0;
+        em::Refl::RecursivelyVisitElemsOfTypeCvref<const int &>(data, [&](const int &x){ret += x;});
+        return ret;
+    }
+
+    [[gnu::noinline]] long long variants_manual(const std::vector<Alternatives> &data)
+    {
+        long long ret = 0;
+        for (const Alternatives &elem : data)
+        {
+            if (const int *x = std::get_if<int>(&elem))
+                ret += *x;
+            else if (const Flat *f = std::get_if<Flat>(&elem))
+                ret += f->a + f->b + f->c + f->d;
+        }
+        return ret;
+    }
+
+    // --- Static members. The "elements" here are the repetitions.
+
+    [[gnu::noinline]] long long statics_refl(std::size_t repeat)
+    {
+        long long ret = 0;
+        for (std::size_t i = 0; i < repeat; i++)
+            em::Refl::RecursivelyVisitStaticElemsMatchingPred<Statics, em::Refl::PredTypeMatchesElemCvref<int &>>([&](int &x){ret += x++;});
+        return ret;
+    }
+
+    [[gnu::noinline]] long long statics_manual(std::size_t repeat)
+    {
+        long long ret = 0;
+        for (std::size_t i = 0; i < repeat; i++)
+        {
+            ret += Statics::s0++;
+            ret += Statics::s1++;
+            ret += Statics::s2++;
+            ret += Statics::s3++;
+            ret += Statics::s4++;
+            ret += Statics::s5++;
+            ret += Statics::s6++;
+            ret += Statics::s7++;
+        }
+        return ret;
+    }
+}
+
+namespace
+{
+    // A simple deterministic generator, to make the data the same on every run.
+    struct Rng
+    {
+        unsigned int state = 12345;
+
+        int operator()(int max)
+        {
+            state = state * 1664525u + 1013904223u;
+            return int((state >> 8) % unsigned(max));
+        }
+    };
+
+    Flat MakeFlat(Rng &rng)
+    {
+        return {rng(100), rng(100), rng(100), rng(100), float(rng(100)), float(rng(100))};
+    }
+
+    // Returns the best time per element in nanoseconds, and the checksum.
+    template <typename F>
+    double Measure(std::size_t num_elements, long long &checksum, F &&func)
+    {
+        // Repeat enough times to take at least ~50ms in total, and take the best run.
+        using clock = std::chrono::steady_clock;
+        double best = 1e300;
+        clock::duration total{};
+        for (int run = 0; run < 1000 && (run < 5 || total < std::chrono::milliseconds(50)); run++)
+        {
+            auto start = clock::now();
+            checksum = func();
+            auto elapsed = clock::now() - start;
+            total += elapsed;
+            best = std::min(best, std::chrono::duration<double, std::nano>(elapsed).count());
+        }
+        return best / double(num_elements);
+    }
+
+    bool failed = false;
+
+    void Report(const char *name, std::size_t num_elements, auto &&refl, auto &&manual)
+    {
+        long long refl_checksum = 0, manual_checksum = 0;
+        double refl_ns = Measure(num_elements, refl_checksum, refl);
+        double manual_ns = Measure(num_elements, manual_checksum, manual);
+        std::printf("%-28s %10zu %12.3f %12.3f %8.2fx\n", name, num_elements, refl_ns, manual_ns, refl_ns / manual_ns);
+        if (refl_checksum != manual_checksum)
+        {
+            std::printf("    Checksum mismatch: %lld vs %lld\n", refl_checksum, manual_checksum);
+            failed = true;
+        }
+    }
+}
+
+int main()
+{
+    std::printf("%-28s %10s %12s %12s %9s\n", "benchmark", "elements", "refl ns/el", "manual ns/el", "ratio");
+
+    for (std::size_t size : {16, 1024, 65536, 1 << 20})
+    {
+        Rng rng;
+
+        std::vector<Flat> flat;
+        for (std::size_t i = 0; i < size; i++)
+            flat.push_back(MakeFlat(rng));
+        Report("flat_visit_members", size, [&]{return Bench::flat_visit_members_refl(flat);}, [&]{return Bench::flat_visit_members_manual(flat);});
+        Report("flat_recursive", size, [&]{return Bench::flat_recursive_refl(flat);}, [&]{return Bench::flat_recursive_manual(flat);});
+
+        // Roughly `size` ints in total.
+        std::vector<Outer> nested;
+        for (std::size_t i = 0; i < size / 16 + 1; i++)
+        {
+            Outer &outer = nested.emplace_back();
+            outer.id = rng(100);
+            for (int j = 0; j < 3; j++)
+            {
+                Inner &inner = outer.inners.emplace_back();
+                inner.x = rng(100);
+                inner.values.resize(std::size_t(rng(8)));
+                for (int &value : inner.values)
+                    value = rng(100);
+            }
+        }
+        Report("nested", size, [&]{return Bench::nested_refl(nested);}, [&]{return Bench::nested_manual(nested);});
+
+        std::vector<WithOptionals> optionals;
+        for (std::size_t i = 0; i < size; i++)
+        {
+            WithOptionals &elem = optionals.emplace_back();
+            if (rng(2))
+                elem.a = rng(100);
+            if (rng(2))
+                elem.b = MakeFlat(rng);
+        }
+        Report("optionals", size, [&]{return Bench::optionals_refl(optionals);}, [&]{return Bench::optionals_manual(optionals);});
+
+        std::vector<Alternatives> variants;
+        for (std::size_t i = 0; i < size; i++)
+        {
+            switch (rng(3))
+            {
+                case 0: variants.emplace_back(rng(100)); break;
+                case 1: variants.emplace_back(MakeFlat(rng)); break;
+                default: variants.emplace_back(std::string(std::size_t(rng(32)), 'x')); break;
+            }
+        }
+        Report("variants", size, [&]{return Bench::variants_refl(variants);}, [&]{return Bench::variants_manual(variants);});
+
+        // Both functions modify the statics, so reset them before each call.
+        auto reset_statics = []{Statics::s0 = Statics::s1 = Statics::s2 = Statics::s3 = Statics::s4 = Statics::s5 = Statics::s6 = Statics::s7 = 1;};
+        Report("statics", size, [&]{reset_statics(); return Bench::statics_refl(size);}, [&]{reset_statics(); return Bench::statics_manual(size);});
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
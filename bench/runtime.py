@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+
+# Builds and runs the runtime benchmarks from `bench/runtime.cpp`, then reports the code size of every benchmark function.
+#
+# Usage:
+#     bench/runtime.py -- clang++ -std=c++23 -O2 -Iinclude -I<path to em/meta and em/macros> [more flags...]
+#
+# The code size of a function includes the lambdas and other local entities defined inside of it that weren't inlined,
+#   but not the out-of-line library functions it calls. Those are listed separately at the end, if there are any.
+
+import os
+import subprocess
+import sys
+import tempfile
+
+
+def symbol_sizes(binary):
+    # Returns `{demangled name: size}` for all defined functions in `binary`.
+    out = subprocess.run(['nm', '-S', '-C', '--defined-only', binary], check=True, capture_output=True, text=True).stdout
+    ret = {}
+    for line in out.splitlines():
+        parts = line.split(' ', 3)
+        if len(parts) == 4 and parts[2] in 'tTwW':
+            ret[parts[3]] = ret.get(parts[3], 0) + int(parts[1], 16)
+    return ret
+
+
+def main():
+    compiler_cmd = [x for x in sys.argv[1:] if x != '--']
+    if not compiler_cmd:
+        sys.stderr.write('Specify the compiler command after `--`.\n')
+        return 2
+
+    source = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'runtime.cpp')
+
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        binary = os.path.join(tmp_dir, 'runtime')
+        if subprocess.run(compiler_cmd + [source, '-o', binary]).returncode != 0:
+            return 1
+
+        run_status = subprocess.run([binary]).returncode
+
+        sizes = symbol_sizes(binary)
+
+    # Group the sizes by the benchmark function, which is the `Bench::...` prefix of the name.
+    bench_sizes = {}
+    library_sizes = {}
+    for name, size in sizes.items():
+        if name.startswith('Bench::'):
+            func = name[:name.index('(')] if '(' in name else name
+            bench_sizes[func] = bench_sizes.get(func, 0) + size
+        elif name.startswith(('em::Refl::', 'void em::Refl::', 'decltype(auto) em::Refl::')):
+            library_sizes[name] = size
+
+    print()
+    print(f'{"benchmark":<28} {"refl bytes":>10} {"manual bytes":>12}')
+    for func in sorted(bench_sizes):
+        if func.endswith('_refl'):
+            base = func[len('Bench::'):-len('_refl')]
+            manual = bench_sizes.get(f'Bench::{base}_manual', 0)
+            print(f'{base:<28} {bench_sizes[func]:>10} {manual:>12}')
+
+    if library_sizes:
+        print('\nOut-of-line library functions:')
+        for name, size in sorted(library_sizes.items(), key = lambda x: -x[1]):
+            print(f'{size:>8}  {name}')
+
+    return run_status
+
+
+if __name__ == '__main__':
+    sys.exit(main())
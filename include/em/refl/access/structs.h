@@ -6,8 +6,13 @@
 #include "em/refl/common.h"
 #include "em/zstring_view.h"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <stdexcept> // IWYU pragma: keep, only used at compile-time.
+#include <string_view>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -94,7 +99,7 @@ namespace em::Refl::Structs
     concept ValidStaticMemberIndex = I >= 0 && I < num_static_members<T>;
 
 
-    // The separation between const and non-const getters is to eventually help with undo-redo, if we ever implement that.
+    // The separation between const and non-const getters helps with undo-redo, see `Journal::GetMemberMutable()` in `em/refl/journal.h`.
 
     // Get `I`th non-static member of a struct, as if the struct was const.
     template <int I, Meta::Deduce..., Type T> requires ValidMemberIndex<T, I>
@@ -270,6 +275,198 @@ namespace em::Refl::Structs
     }
 
 
+    namespace detail
+    {
+        // The 64-bit finalizer from MurmurHash3.
+        [[nodiscard]] constexpr std::uint64_t MixHash(std::uint64_t x)
+        {
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdull;
+            x ^= x >> 33;
+            x *= 0xc4ceb9fe1a85ec53ull;
+            x ^= x >> 33;
+            return x;
+        }
+
+        // FNV-1a, followed by `MixHash()` to make sure the low bits depend on the entire input.
+        [[nodiscard]] constexpr std::uint64_t HashName(std::string_view name)
+        {
+            std::uint64_t ret = 0xcbf29ce484222325ull;
+            for (char ch : name)
+            {
+                ret ^= (unsigned char)ch;
+                ret *= 0x100000001b3ull;
+            }
+            return MixHash(ret);
+        }
+
+        // A minimal perfect hash over `N` distinct names, using the "hash and displace" scheme.
+        // The name hash selects a bucket, and each bucket stores a seed that maps its names to distinct free slots.
+        template <int N>
+        struct PerfectNameHash
+        {
+            std::array<std::uint32_t, N> seeds{}; // Per bucket.
+            std::array<int, N> indices{}; // Per slot, the name index.
+
+            // Returns the index of `name` in `names` (which must be the same array that was used to construct this), or -1 if not found.
+            [[nodiscard]] constexpr int Find(const std::array<std::string_view, N> &names, std::string_view name) const
+            {
+                if constexpr (N == 0)
+                {
+                    return -1;
+                }
+                else
+                {
+                    const std::uint64_t hash = HashName(name);
+                    const int i = indices[std::size_t(MixHash(hash ^ MixHash(seeds[std::size_t(hash % N)])) % N)];
+                    return names[std::size_t(i)] == name ? i : -1;
+                }
+            }
+        };
+
+        // This is only supposed to run at compile-time.
+        template <int N>
+        [[nodiscard]] constexpr PerfectNameHash<N> MakePerfectNameHash(const std::array<std::string_view, N> &names)
+        {
+            PerfectNameHash<N> ret;
+
+            if constexpr (N > 0)
+            {
+                std::array<std::uint64_t, N> hashes{};
+                std::array<int, N> bucket_sizes{};
+                for (std::size_t i = 0; i < N; i++)
+                {
+                    hashes[i] = HashName(names[i]);
+                    bucket_sizes[hashes[i] % N]++;
+                }
+
+                // Group the names by bucket, largest buckets first, since those are the hardest to place.
+                std::array<int, N> keys{};
+                for (int i = 0; i < N; i++)
+                    keys[std::size_t(i)] = i;
+                std::sort(keys.begin(), keys.end(), [&](int a, int b)
+                {
+                    const std::size_t bucket_a = hashes[std::size_t(a)] % N;
+                    const std::size_t bucket_b = hashes[std::size_t(b)] % N;
+                    if (bucket_sizes[bucket_a] != bucket_sizes[bucket_b])
+                        return bucket_sizes[bucket_a] > bucket_sizes[bucket_b];
+                    return bucket_a < bucket_b;
+                });
+
+                std::array<bool, N> slot_taken{};
+                std::size_t begin = 0;
+                while (begin < N)
+                {
+                    const std::size_t bucket = hashes[std::size_t(keys[begin])] % N;
+                    const std::size_t end = begin + std::size_t(bucket_sizes[bucket]);
+
+                    for (std::uint32_t seed = 0;; seed++)
+                    {
+                        // Stay below the default `-fconstexpr-loop-limit` of GCC (262144), to get this error instead of a cryptic one.
+                        if (seed == 100'000)
+                            throw std::logic_error("Failed to build a perfect hash for the member names. Are there duplicate names?");
+
+                        std::array<std::size_t, N> slots{};
+                        bool ok = true;
+                        for (std::size_t i = begin; ok && i < end; i++)
+                        {
+                            slots[i] = std::size_t(MixHash(hashes[std::size_t(keys[i])] ^ MixHash(seed)) % N);
+                            ok = !slot_taken[slots[i]] && std::find(slots.begin() + std::ptrdiff_t(begin), slots.begin() + std::ptrdiff_t(i), slots[i]) == slots.begin() + std::ptrdiff_t(i);
+                        }
+                        if (!ok)
+                            continue;
+
+                        for (std::size_t i = begin; i < end; i++)
+                        {
+                            slot_taken[slots[i]] = true;
+                            ret.indices[slots[i]] = keys[i];
+                        }
+                        ret.seeds[bucket] = seed;
+                        break;
+                    }
+
+                    begin = end;
+                }
+            }
+
+            return ret;
+        }
+
+        template <typename T, bool IsStatic>
+        struct MemberNameLookup
+        {
+            static constexpr int n = []{
+                if constexpr (IsStatic)
+                    return num_static_members<T>;
+                else
+                    return num_members<T>;
+            }();
+
+            static constexpr std::array<std::string_view, n> names = []{
+                std::array<std::string_view, n> ret{};
+                for (int i = 0; i < n; i++)
+                {
+                    if constexpr (IsStatic)
+                        ret[std::size_t(i)] = std::string_view(GetStaticMemberName<T>(i));
+                    else
+                        ret[std::size_t(i)] = std::string_view(GetMemberName<T>(i));
+                }
+                return ret;
+            }();
+
+            static constexpr PerfectNameHash<n> hash = MakePerfectNameHash<n>(names);
+        };
+    }
+
+    // Returns the index of the non-static member called `name`, or -1 if there's no such member. Cvref-qualifiers on `T` are ignored.
+    // This uses a perfect hash generated at compile-time, so it's O(1) regardless of the member count.
+    template <HasMemberNames T>
+    [[nodiscard]] constexpr int FindMemberByName(std::string_view name)
+    {
+        using Lookup = detail::MemberNameLookup<std::remove_cvref_t<T>, false>;
+        return Lookup::hash.Find(Lookup::names, name);
+    }
+
+    // Returns the index of the static member called `name`, or -1 if there's no such member. Cvref-qualifiers on `T` are ignored.
+    // This uses a perfect hash generated at compile-time, so it's O(1) regardless of the member count.
+    template <typename T>
+    [[nodiscard]] constexpr int FindStaticMemberByName(std::string_view name)
+    {
+        using Lookup = detail::MemberNameLookup<std::remove_cvref_t<T>, true>;
+        return Lookup::hash.Find(Lookup::names, name);
+    }
+
+
+    // Does the struct provide the member layout information?
+    // `EM_REFL()` provides it for standard-layout classes without reference members.
+    template <typename T>
+    concept HasMemberLayout = Type<T> && requires{detail::NonStaticTraits<T>::GetMemberLayout();};
+
+    namespace detail
+    {
+        template <HasMemberLayout T>
+        constexpr std::array<MemberLayoutEntry, num_members<T>> member_layout = NonStaticTraits<T>::GetMemberLayout();
+    }
+
+    // Returns the offsets, sizes, alignments and type IDs of all non-static members of `T`, in the same order as the member indices.
+    // Cvref-qualifiers on `T` are ignored.
+    // This lets you process members with a runtime loop, instead of instantiating a template per member.
+    template <HasMemberLayout T>
+    [[nodiscard]] constexpr const std::array<MemberLayoutEntry, num_members<T>> &MemberLayout()
+    {
+        return detail::member_layout<std::remove_cvref_t<T>>;
+    }
+
+    // Returns the address of a member described by `entry`, which must be one of the elements of `MemberLayout<T>()`.
+    // Preserves the constness of `object`.
+    template <Meta::Deduce..., HasMemberLayout T>
+    [[nodiscard]] auto *GetMemberAddress(T &object, const MemberLayoutEntry &entry)
+    {
+        using Byte = std::conditional_t<std::is_const_v<T>, const unsigned char, unsigned char>;
+        return reinterpret_cast<Byte *>(&object) + entry.offset;
+    }
+
+
     // This recognizes the tuple-like classes so we can provide an implementation for them.
     template <typename T>
     concept DefaultTupleLike = requires{std::tuple_size<std::remove_cvref_t<T>>::value;}; // `std::tuple_size_v` is not SFINAE-friendly.
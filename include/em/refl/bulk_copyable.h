@@ -0,0 +1,186 @@
+#pragma once
+
+#include "em/meta/common.h"
+#include "em/refl/classify.h"
+#include "em/refl/common.h"
+
+#include <cstddef>
+#include <limits>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Detects the types whose object representation is just the concatenation of their leaf elements, with no padding in between.
+// Such objects can be serialized or hashed as raw bytes, instead of visiting them member by member, and some of them can be compared as raw bytes too.
+
+namespace em::Refl
+{
+    namespace detail::BulkCopy
+    {
+        // Whether all bits of the floating-point type `T` are value bits. Checks for the IEEE binary16/32/64/128 formats.
+        // This rejects e.g. the x87 80-bit `long double`, which has 6 padding bytes on x86-64.
+        template <typename T>
+        constexpr bool float_has_no_padding = std::numeric_limits<T>::is_iec559 && (
+            (std::numeric_limits<T>::digits == 11 && sizeof(T) == 2) ||
+            (std::numeric_limits<T>::digits == 24 && sizeof(T) == 4) ||
+            (std::numeric_limits<T>::digits == 53 && sizeof(T) == 8) ||
+            (std::numeric_limits<T>::digits == 113 && sizeof(T) == 16)
+        );
+
+        template <typename T, typename ExcludeAttr, bool AllowFloats>
+        constexpr bool IsBulkCopyable();
+
+        // Whether the members of `T` have no padding between them, are in the declaration order, and are all bulk-copyable themselves.
+        template <typename T, typename ExcludeAttr, bool AllowFloats, std::size_t ...I>
+        constexpr bool StructMembersAreBulkCopyable(std::index_sequence<I...>)
+        {
+            if constexpr (!(IsBulkCopyable<Structs::MemberType<T, I>, ExcludeAttr, AllowFloats>() && ...) || (std::is_const_v<Structs::MemberType<T, I>> || ...))
+            {
+                return false;
+            }
+            else
+            {
+                // This has to be a separate `if constexpr`, since `member_has_attribute<..., void>` is a hard error.
+                if constexpr (!std::is_void_v<ExcludeAttr>)
+                {
+                    if constexpr ((Structs::member_has_attribute<T, I, ExcludeAttr> || ...))
+                        return false;
+                }
+
+                std::size_t expected_offset = 0;
+                for (const MemberLayoutEntry &entry : Structs::MemberLayout<T>())
+                {
+                    if (entry.offset != expected_offset)
+                        return false;
+                    expected_offset += entry.size;
+                }
+                return expected_offset == sizeof(T);
+            }
+        }
+
+        // Whether `T` is a `std::array`-like tuple with no padding between the elements.
+        template <typename T, typename ExcludeAttr, bool AllowFloats>
+        constexpr bool IsBulkCopyableArrayLike()
+        {
+            if constexpr (Structs::DefaultTupleLike<T> && std::ranges::contiguous_range<T> && requires{typename std::ranges::range_value_t<T>;})
+            {
+                using Elem = std::ranges::range_value_t<T>;
+                return IsBulkCopyable<Elem, ExcludeAttr, AllowFloats>() && sizeof(T) == std::tuple_size_v<T> * sizeof(Elem);
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        template <typename T, typename ExcludeAttr, bool AllowFloats>
+        constexpr bool IsBulkCopyable()
+        {
+            if constexpr (!Meta::cvref_unqualified<std::remove_const_t<T>> || !std::is_trivially_copyable_v<T> || Adjust::NeedsAdjustment<T>)
+                return false;
+            else if constexpr (std::is_floating_point_v<T>)
+                return AllowFloats && float_has_no_padding<T>;
+            else if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+                return std::has_unique_object_representations_v<T>;
+            else if constexpr (std::is_array_v<T>)
+                return IsBulkCopyable<std::remove_all_extents_t<T>, ExcludeAttr, AllowFloats>();
+            else if constexpr (Structs::HasMemberLayout<T> && !Bases::HasBases<T>)
+                return StructMembersAreBulkCopyable<T, ExcludeAttr, AllowFloats>(std::make_index_sequence<Structs::num_members<T>>{});
+            else
+                return IsBulkCopyableArrayLike<T, ExcludeAttr, AllowFloats>();
+        }
+
+        // Whether the `BulkCopyable` type `T` contains `bool`s. This mirrors `IsBulkCopyable()`.
+        template <typename T>
+        constexpr bool ContainsBool()
+        {
+            if constexpr (std::is_same_v<T, bool>)
+                return true;
+            else if constexpr (std::is_array_v<T>)
+                return ContainsBool<std::remove_cv_t<std::remove_all_extents_t<T>>>();
+            else if constexpr (Structs::HasMemberLayout<T>)
+                return []<int ...I>(std::integer_sequence<int, I...>){return (ContainsBool<std::remove_cv_t<Structs::MemberType<T, I>>>() || ...);}(std::make_integer_sequence<int, Structs::num_members<T>>{});
+            else if constexpr (std::ranges::contiguous_range<T>)
+                return ContainsBool<std::remove_cv_t<std::ranges::range_value_t<T>>>();
+            else
+                return false;
+        }
+
+        template <typename T>
+        [[nodiscard]] bool BoolsAreValid(const unsigned char *data)
+        {
+            if constexpr (!ContainsBool<T>())
+            {
+                (void)data;
+                return true;
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+            {
+                return *data <= 1;
+            }
+            else if constexpr (std::is_array_v<T> || !Structs::HasMemberLayout<T>)
+            {
+                using Elem = std::remove_cv_t<std::conditional_t<std::is_array_v<T>, std::remove_all_extents_t<T>, std::ranges::range_value_t<T>>>;
+                for (std::size_t i = 0; i < sizeof(T) / sizeof(Elem); i++)
+                {
+                    if (!BoolsAreValid<Elem>(data + i * sizeof(Elem)))
+                        return false;
+                }
+                return true;
+            }
+            else
+            {
+                return []<int ...I>(const unsigned char *data, std::integer_sequence<int, I...>){
+                    return (BoolsAreValid<std::remove_cv_t<Structs::MemberType<T, I>>>(data + Structs::MemberLayout<T>()[I].offset) && ...);
+                }(data, std::make_integer_sequence<int, Structs::num_members<T>>{});
+            }
+        }
+    }
+
+    // Whether `T` can be processed as a single block of bytes. Cvref-qualifiers are ignored.
+    // This is true for arithmetic types and enums without padding bits (so not the x87 `long double`), arrays of those, and `EM_REFL()` structs without bases whose members are bulk-copyable and have no padding between them.
+    // If `ExcludeAttr` isn't void, the structs having members with this attribute (or one inherited from it) are rejected too,
+    //   since a block copy can't skip those members.
+    template <typename T, typename ExcludeAttr = void>
+    concept BulkCopyable = detail::BulkCopy::IsBulkCopyable<std::remove_cvref_t<T>, ExcludeAttr, true>();
+
+    // Like `BulkCopyable`, but also rejects floating-point types. Two such objects are equal if and only if their bytes are equal,
+    //   so they can be compared with `memcmp()`. (For floating-point numbers this doesn't work, because of `-0.0 == 0.0` and `NaN != NaN`.)
+    template <typename T, typename ExcludeAttr = void>
+    concept BitwiseComparable = detail::BulkCopy::IsBulkCopyable<std::remove_cvref_t<T>, ExcludeAttr, false>();
+
+    // Whether not every byte pattern is a valid object of the `BulkCopyable` type `T`. This is the case if it contains `bool`s, which must be 0 or 1.
+    // When copying such types from untrusted bytes, check them with `BulkBytesAreValid()` first, since reading an invalid `bool` is UB.
+    template <typename T>
+    concept BulkCopyableNeedsValidation = BulkCopyable<T> && detail::BulkCopy::ContainsBool<std::remove_cvref_t<T>>();
+
+    // Checks the bytes of `count` consecutive objects of the `BulkCopyable` type `T`. Returns false if some `bool` in them isn't 0 or 1.
+    template <BulkCopyable T>
+    [[nodiscard]] bool BulkBytesAreValid(const void *data, std::size_t count = 1)
+    {
+        using U = std::remove_cvref_t<T>;
+        if constexpr (BulkCopyableNeedsValidation<U>)
+        {
+            for (std::size_t i = 0; i < count; i++)
+            {
+                if (!detail::BulkCopy::BoolsAreValid<U>(static_cast<const unsigned char *>(data) + i * sizeof(U)))
+                    return false;
+            }
+        }
+        else
+        {
+            (void)data;
+            (void)count;
+        }
+        return true;
+    }
+
+    // A contiguous sized range of `BulkCopyable` elements, which can be processed as a single block of bytes too.
+    template <typename T, typename ExcludeAttr = void>
+    concept ContiguousBulkRange = std::ranges::contiguous_range<T> && std::ranges::sized_range<T> && BulkCopyable<std::ranges::range_value_t<T>, ExcludeAttr>;
+
+    // A contiguous sized range of `BitwiseComparable` elements.
+    template <typename T, typename ExcludeAttr = void>
+    concept ContiguousBitwiseComparableRange = std::ranges::contiguous_range<T> && std::ranges::sized_range<T> && BitwiseComparable<std::ranges::range_value_t<T>, ExcludeAttr>;
+}
@@ -5,6 +5,7 @@
 #include "em/meta/lists.h"
 
 #include <concepts>
+#include <cstddef>
 
 namespace em::Refl
 {
@@ -31,6 +32,28 @@ namespace em::Refl
     };
 
 
+    namespace detail
+    {
+        // Only the address of this matters. This must be `inline` to have the same address in all TUs.
+        template <typename T>
+        inline constexpr char type_id_tag = 0;
+    }
+
+    // A unique compile-time address for each type. Cvref-qualifiers are significant, so strip them before comparing if you don't care about them.
+    // This is only useful for comparing types at runtime, e.g. in `MemberLayoutEntry` below.
+    template <typename T>
+    constexpr const void *type_id = &detail::type_id_tag<T>;
+
+    // Describes the physical location of a non-static struct member. See `Structs::MemberLayout()`.
+    struct MemberLayoutEntry
+    {
+        std::size_t offset = 0;
+        std::size_t size = 0;
+        std::size_t alignment = 0;
+        const void *type_id = nullptr; // `Refl::type_id` of the member type with cv-qualifiers removed (the member can't be a reference), so a `const int` member matches `type_id<int>`.
+    };
+
+
     // --- Visiting:
 
     enum class VisitMode
@@ -0,0 +1,248 @@
+#pragma once
+
+#include "em/meta/common.h"
+#include "em/refl/bulk_copyable.h"
+#include "em/refl/classify.h"
+#include "em/refl/common.h"
+#include "em/refl/visit_members.h"
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+// Structural equality and three-way comparison of reflected types.
+// Both walk the two objects in lockstep, in the `VisitMembers()` order, and stop at the first difference.
+// Ranges are compared lexicographically, nullable indirect types consider the lack of value to be less than any value,
+//   and variants are compared by the index first, like `std::variant` does.
+//
+// The subtrees that are `BitwiseComparable`, the contiguous runs of such struct members, and the contiguous ranges of such elements
+//   are compared with `memcmp()` first. `Compare()` then falls back to the member-wise comparison only for the part that differs.
+// The `memcmp()` shortcuts are disabled in constant evaluation.
+
+namespace em::Refl
+{
+    // Put this attribute on `EM_REFL()` members to exclude them from `Equal()` and `Compare()`.
+    struct CompareIgnore : BasicAttribute {};
+
+    namespace detail::Compare
+    {
+        // Describes how the `I`th member of a struct participates in a run of members that can be compared with a single `memcmp()`.
+        enum class RunKind {none, start, interior};
+
+        // For every member of `T`: whether it starts a run, is inside of a run, or is not a part of any run.
+        // A run is two or more adjacent `BitwiseComparable` members without padding between them.
+        template <typename T, std::size_t ...I>
+        constexpr std::array<RunKind, sizeof...(I)> ComputeMemberRuns(std::index_sequence<I...>)
+        {
+            std::array<RunKind, sizeof...(I)> ret{};
+            if constexpr (Structs::HasMemberLayout<T>)
+            {
+                constexpr bool eligible[] = {(BitwiseComparable<Structs::MemberType<T, I>, CompareIgnore> && !Structs::member_has_attribute<T, I, CompareIgnore>)...};
+                const auto &layout = Structs::MemberLayout<T>();
+
+                for (std::size_t i = 1; i < sizeof...(I); i++)
+                {
+                    if (eligible[i - 1] && eligible[i] && layout[i - 1].offset + layout[i - 1].size == layout[i].offset)
+                    {
+                        if (ret[i - 1] == RunKind::none)
+                            ret[i - 1] = RunKind::start;
+                        ret[i] = RunKind::interior;
+                    }
+                }
+            }
+            return ret;
+        }
+
+        template <typename T>
+        constexpr auto member_runs = ComputeMemberRuns<T>(std::make_index_sequence<Structs::num_members<T>>{});
+
+        // Returns the index one past the last member of the run starting at `I`.
+        template <typename T, std::size_t I>
+        constexpr std::size_t run_end = []{
+            std::size_t i = I + 1;
+            while (i < member_runs<T>.size() && member_runs<T>[i] == RunKind::interior)
+                i++;
+            return i;
+        }();
+
+        // If `Ordered` is false, returns either `equivalent` or `unordered`, and returns as soon as it finds any difference.
+        template <bool Ordered, VisitMode Mode = VisitMode::normal, Meta::Deduce..., typename T>
+        [[nodiscard]] constexpr std::partial_ordering CompareLow(const T &a, const T &b)
+        {
+            constexpr Category c = classify_opt<T>;
+
+            if constexpr (BitwiseComparable<T, CompareIgnore> && !std::is_scalar_v<T>)
+            {
+                if !consteval
+                {
+                    if (std::memcmp(&a, &b, sizeof(T)) == 0)
+                        return std::partial_ordering::equivalent;
+                    if constexpr (!Ordered)
+                        return std::partial_ordering::unordered;
+                }
+            }
+
+            if constexpr (c == Category::adjust)
+            {
+                return (CompareLow<Ordered>)(Adjust::Adjust(a), Adjust::Adjust(b));
+            }
+            else if constexpr (c == Category::indirect)
+            {
+                if constexpr (!Indirect::AlwaysHasValue<T>)
+                {
+                    const bool has_a = Indirect::HasValue(a);
+                    const bool has_b = Indirect::HasValue(b);
+                    if (has_a != has_b || !has_a)
+                        return has_a <=> has_b;
+                }
+                return (CompareLow<Ordered>)(Indirect::GetValue(a), Indirect::GetValue(b));
+            }
+            else if constexpr (c == Category::structure)
+            {
+                std::partial_ordering ret = std::partial_ordering::equivalent;
+                bool skip_run = false;
+
+                (void)(VisitMembers<Meta::LoopAnyOf<>, IterationFlags{}, Mode>)(a, [&]<VisitDesc Desc>(const auto &member_a) -> bool
+                {
+                    if constexpr (std::derived_from<Desc, VisitingAnyBase>)
+                    {
+                        ret = (CompareLow<Ordered, Desc::mode>)(member_a, Bases::CastToBase<std::remove_cvref_t<decltype(member_a)>>(b));
+                    }
+                    else if constexpr (Structs::member_has_attribute<T, Desc::value, CompareIgnore>)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        constexpr RunKind run = member_runs<T>[Desc::value];
+                        if constexpr (run == RunKind::interior)
+                        {
+                            if (skip_run)
+                                return false;
+                        }
+                        else if constexpr (run == RunKind::start)
+                        {
+                            if !consteval
+                            {
+                                const auto &layout = Structs::MemberLayout<T>();
+                                const std::size_t begin = layout[Desc::value].offset;
+                                const std::size_t end = layout[run_end<T, Desc::value> - 1].offset + layout[run_end<T, Desc::value> - 1].size;
+                                skip_run = std::memcmp(Structs::GetMemberAddress(a, layout[Desc::value]), Structs::GetMemberAddress(b, layout[Desc::value]), end - begin) == 0;
+                                if (skip_run)
+                                    return false;
+                                if constexpr (!Ordered)
+                                {
+                                    ret = std::partial_ordering::unordered;
+                                    return true;
+                                }
+                            }
+                        }
+
+                        ret = (CompareLow<Ordered, Desc::mode>)(member_a, Structs::GetMemberConst<Desc::value>(b));
+                    }
+                    return ret != 0;
+                });
+
+                return ret;
+            }
+            else if constexpr (c == Category::range)
+            {
+                if constexpr (ContiguousBitwiseComparableRange<const T, CompareIgnore>)
+                {
+                    if !consteval
+                    {
+                        const std::size_t size_a = std::size_t(std::ranges::size(a));
+                        const std::size_t size_b = std::size_t(std::ranges::size(b));
+                        constexpr std::size_t elem_size = sizeof(std::ranges::range_value_t<T>);
+
+                        if constexpr (!Ordered)
+                        {
+                            if (size_a != size_b)
+                                return std::partial_ordering::unordered;
+                            if (size_a == 0 || std::memcmp(std::ranges::data(a), std::ranges::data(b), size_a * elem_size) == 0)
+                                return std::partial_ordering::equivalent;
+                            return std::partial_ordering::unordered;
+                        }
+                        else
+                        {
+                            const std::size_t n = std::min(size_a, size_b);
+                            const auto *data_a = std::ranges::data(a);
+                            const auto *data_b = std::ranges::data(b);
+                            if (n > 0 && std::memcmp(data_a, data_b, n * elem_size) != 0)
+                            {
+                                // Find the first element that differs, and compare it properly.
+                                for (std::size_t i = 0; i < n; i++)
+                                {
+                                    if (std::memcmp(data_a + i, data_b + i, elem_size) != 0)
+                                        return (CompareLow<Ordered>)(data_a[i], data_b[i]);
+                                }
+                            }
+                            return size_a <=> size_b;
+                        }
+                    }
+                }
+
+                if constexpr (!Ordered && std::ranges::sized_range<const T>)
+                {
+                    if (std::ranges::size(a) != std::ranges::size(b))
+                        return std::partial_ordering::unordered;
+                }
+
+                auto it_a = std::ranges::begin(a), end_a = std::ranges::end(a);
+                auto it_b = std::ranges::begin(b), end_b = std::ranges::end(b);
+                for (; it_a != end_a && it_b != end_b; ++it_a, ++it_b)
+                {
+                    if (std::partial_ordering ret = (CompareLow<Ordered>)(*it_a, *it_b); ret != 0)
+                        return ret;
+                }
+                return (it_a != end_a) <=> (it_b != end_b);
+            }
+            else if constexpr (c == Category::variant)
+            {
+                // Adding one makes the valueless state (`std::variant_npos`) wrap around to zero, so it's less than everything else, like in `std::variant`.
+                const std::size_t index_a = a.index() + 1;
+                const std::size_t index_b = b.index() + 1;
+                if (index_a != index_b || index_a == 0)
+                    return index_a <=> index_b;
+
+                std::partial_ordering ret = std::partial_ordering::equivalent;
+                (VisitMembers<Meta::LoopSimple>)(a, [&]<VisitDesc Desc>(const auto &alt)
+                {
+                    ret = (CompareLow<Ordered, Desc::mode>)(alt, Variants::Get<Desc::value>(b));
+                });
+                return ret;
+            }
+            else if constexpr (!Ordered)
+            {
+                static_assert(std::equality_comparable<T>, "Don't know how to compare this type.");
+                return a == b ? std::partial_ordering::equivalent : std::partial_ordering::unordered;
+            }
+            else
+            {
+                static_assert(requires{std::compare_partial_order_fallback(a, b);}, "Don't know how to compare this type.");
+                return std::compare_partial_order_fallback(a, b);
+            }
+        }
+    }
+
+    // Returns true if `a` and `b` are structurally equal. Members with the `CompareIgnore` attribute are skipped.
+    template <Meta::Deduce..., typename T>
+    [[nodiscard]] constexpr bool Equal(const T &a, const T &b)
+    {
+        return (detail::Compare::CompareLow<false>)(a, b) == 0;
+    }
+
+    // Compares `a` and `b` structurally and lexicographically. Members with the `CompareIgnore` attribute are skipped.
+    // The result is `unordered` if some leaf elements are unordered, e.g. floating-point NaNs.
+    template <Meta::Deduce..., typename T>
+    [[nodiscard]] constexpr std::partial_ordering Compare(const T &a, const T &b)
+    {
+        return (detail::Compare::CompareLow<true>)(a, b);
+    }
+}
@@ -0,0 +1,370 @@
+#pragma once
+
+#include "em/meta/common.h"
+#include "em/refl/classify.h"
+#include "em/refl/common.h"
+#include "em/refl/compare.h"
+#include "em/refl/macros/structs.h"
+#include "em/refl/serialize/binary.h"
+#include "em/refl/visit_members.h"
+
+#include <fmt/format.h>
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <stdexcept> // IWYU pragma: keep, clearly used below.
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+// Structural diffs of reflected types.
+// `Diff(old, new)` produces a `Patch`, which is a list of operations that `ApplyPatch()` then applies to a copy of `old` to turn it into `new`.
+// Each operation has a path from the root object to the changed subtree, and either the serialized new value of that subtree, or the new size of a range.
+//
+// The unchanged subtrees are skipped with `Equal()` (so `memcmp()` where possible), and the members with the `CompareIgnore` attribute aren't compared,
+//   so changing only them doesn't produce any operations.
+// We only descend into variants if the alternative index is the same, into nullable indirect types if both have values,
+//   and into ranges that are random-access (element by element, resizing them if needed).
+// Otherwise the whole subtree is replaced. The ranges of `BitwiseComparable` elements are replaced as a whole too, if that gives a smaller patch than the per-element operations.
+//
+// The values are serialized with `em/refl/serialize/binary.h`, so the same limitations apply.
+// The patch itself is a reflected struct, so it can be serialized with it too.
+
+namespace em::Refl
+{
+    // How a path step descends into a subobject.
+    enum class PatchStepKind : std::uint8_t
+    {
+        member, // `index` is the member index, as in `VisitingClassMember`.
+        base, // `index` is the base index, in the `VisitMembers()` order.
+        element, // `index` is the range element index.
+        alternative, // `index` is the variant alternative index, which must match the current one.
+        value, // Into the value of an indirect type, such as `std::optional`. `index` is unused.
+    };
+
+    struct PatchStep
+    {
+        EM_REFL(
+            (PatchStepKind)(kind)
+            (std::uint64_t)(index)
+        )
+    };
+
+    enum class PatchOpKind : std::uint8_t
+    {
+        replace, // Replace the subtree with the deserialized `value`.
+        resize, // Resize the range to `size`. This is followed by the `replace` operations for the new elements, if any.
+    };
+
+    struct PatchOp
+    {
+        EM_REFL(
+            (PatchOpKind)(kind)
+            (std::vector<PatchStep>)(path)
+            (std::uint64_t)(size)
+            (std::vector<unsigned char>)(value)
+        )
+    };
+
+    struct Patch
+    {
+        EM_REFL(
+            (std::vector<PatchOp>)(ops)
+        )
+
+        // Returns true if the patch doesn't change anything.
+        [[nodiscard]] bool IsEmpty() const {return ops.empty();}
+    };
+
+    namespace detail::Diff
+    {
+        template <typename T>
+        concept ElementwiseDiffableRange = std::ranges::random_access_range<T> && std::ranges::sized_range<T>;
+
+        template <typename T>
+        concept ResizableRange = requires(T &t, std::size_t n){t.resize(n);};
+
+        // The size of a `PatchOp` when serialized with `Binary::Write()`, given the number of path steps and the value size. Used to pick the smaller of the alternative patches.
+        [[nodiscard]] constexpr std::size_t EncodedOpSize(std::size_t path_size, std::size_t value_size)
+        {
+            constexpr std::size_t step_size = sizeof(PatchStepKind) + sizeof(std::uint64_t);
+            return sizeof(PatchOpKind) + sizeof(std::uint64_t) + path_size * step_size + sizeof(std::uint64_t) + sizeof(std::uint64_t) + value_size;
+        }
+
+        struct Context
+        {
+            Patch &patch;
+            std::vector<PatchStep> path;
+
+            template <typename T>
+            void Replace(const T &value)
+            {
+                patch.ops.push_back({.kind = PatchOpKind::replace, .path = path, .value = Binary::ToBytes(value)});
+            }
+        };
+
+        template <VisitMode Mode = VisitMode::normal, Meta::Deduce..., typename T>
+        void DiffLow(Context &ctx, const T &a, const T &b)
+        {
+            constexpr Category c = classify_opt<T>;
+
+            // Prune the unchanged subtrees. For the types without `memcmp()` shortcuts this would be as expensive as diffing, so we don't do it for them.
+            if constexpr (BitwiseComparable<T, CompareIgnore> || c == Category::unknown)
+            {
+                if (Equal(a, b))
+                    return;
+            }
+
+            if constexpr (c == Category::adjust)
+            {
+                (DiffLow)(ctx, Adjust::Adjust(a), Adjust::Adjust(b));
+            }
+            else if constexpr (c == Category::indirect)
+            {
+                if constexpr (!Indirect::AlwaysHasValue<T>)
+                {
+                    const bool has_a = Indirect::HasValue(a);
+                    const bool has_b = Indirect::HasValue(b);
+                    if (has_a != has_b)
+                    {
+                        ctx.Replace(b);
+                        return;
+                    }
+                    if (!has_a)
+                        return;
+                }
+
+                ctx.path.push_back({.kind = PatchStepKind::value});
+                (DiffLow)(ctx, Indirect::GetValue(a), Indirect::GetValue(b));
+                ctx.path.pop_back();
+            }
+            else if constexpr (c == Category::structure)
+            {
+                std::uint64_t base_index = 0;
+                (VisitMembers<Meta::LoopSimple, IterationFlags{}, Mode>)(a, [&]<VisitDesc Desc>(const auto &member_a)
+                {
+                    if constexpr (std::derived_from<Desc, VisitingAnyBase>)
+                    {
+                        ctx.path.push_back({.kind = PatchStepKind::base, .index = base_index++});
+                        (DiffLow<Desc::mode>)(ctx, member_a, Bases::CastToBase<std::remove_cvref_t<decltype(member_a)>>(b));
+                        ctx.path.pop_back();
+                    }
+                    else if constexpr (!Structs::member_has_attribute<T, Desc::value, CompareIgnore>)
+                    {
+                        ctx.path.push_back({.kind = PatchStepKind::member, .index = std::uint64_t(Desc::value)});
+                        (DiffLow<Desc::mode>)(ctx, member_a, Structs::GetMemberConst<Desc::value>(b));
+                        ctx.path.pop_back();
+                    }
+                });
+            }
+            else if constexpr (c == Category::range)
+            {
+                if constexpr (ElementwiseDiffableRange<const T>)
+                {
+                    const std::size_t size_a = std::size_t(std::ranges::size(a));
+                    const std::size_t size_b = std::size_t(std::ranges::size(b));
+                    const std::size_t first_op = ctx.patch.ops.size();
+
+                    if (size_a != size_b)
+                    {
+                        if constexpr (ResizableRange<T>)
+                            ctx.patch.ops.push_back({.kind = PatchOpKind::resize, .path = ctx.path, .size = size_b});
+                        else
+                            return ctx.Replace(b);
+                    }
+                    else if constexpr (ContiguousBitwiseComparableRange<const T, CompareIgnore>)
+                    {
+                        if (Equal(a, b))
+                            return;
+                    }
+
+                    auto it_a = std::ranges::begin(a);
+                    auto it_b = std::ranges::begin(b);
+                    for (std::size_t i = 0; i < size_b; i++, ++it_b)
+                    {
+                        ctx.path.push_back({.kind = PatchStepKind::element, .index = i});
+                        if (i < size_a)
+                        {
+                            (DiffLow)(ctx, *it_a, *it_b);
+                            ++it_a;
+                        }
+                        else
+                        {
+                            ctx.Replace(*it_b);
+                        }
+                        ctx.path.pop_back();
+                    }
+
+                    if constexpr (ContiguousBitwiseComparableRange<const T, CompareIgnore>)
+                    {
+                        // Every changed element got its own operation. If there are many of them, replacing the whole range is smaller.
+                        std::size_t elementwise_size = 0;
+                        for (std::size_t i = first_op; i < ctx.patch.ops.size(); i++)
+                            elementwise_size += EncodedOpSize(ctx.patch.ops[i].path.size(), ctx.patch.ops[i].value.size());
+
+                        const std::size_t whole_size = EncodedOpSize(ctx.path.size(), sizeof(std::uint64_t) + size_b * sizeof(std::ranges::range_value_t<T>));
+                        if (whole_size < elementwise_size)
+                        {
+                            ctx.patch.ops.erase(ctx.patch.ops.begin() + std::ptrdiff_t(first_op), ctx.patch.ops.end());
+                            ctx.Replace(b);
+                        }
+                    }
+                }
+                else
+                {
+                    if (!Equal(a, b))
+                        ctx.Replace(b);
+                }
+            }
+            else if constexpr (c == Category::variant)
+            {
+                // `valueless_by_exception()` is optional for variant-like types, but `index()` returns -1 in that case anyway.
+                if (a.index() != b.index() || a.index() >= std::variant_size_v<T>)
+                    return ctx.Replace(b);
+
+                (VisitMembers<Meta::LoopSimple>)(a, [&]<VisitDesc Desc>(const auto &alt)
+                {
+                    ctx.path.push_back({.kind = PatchStepKind::alternative, .index = std::uint64_t(Desc::value)});
+                    (DiffLow<Desc::mode>)(ctx, alt, Variants::Get<Desc::value>(b));
+                    ctx.path.pop_back();
+                });
+            }
+            else
+            {
+                // A leaf that we already know is different.
+                ctx.Replace(b);
+            }
+        }
+
+        [[noreturn]] inline void ThrowBadPath(const PatchOp &op, std::size_t step_index, std::string_view reason)
+        {
+            throw std::runtime_error(fmt::format("Refl::ApplyPatch: can't apply step {} of {} of the path: {}", step_index, op.path.size(), reason));
+        }
+
+        template <VisitMode Mode = VisitMode::normal, Meta::Deduce..., typename T>
+        void ApplyLow(T &value, const PatchOp &op, std::size_t step_index)
+        {
+            static_assert(!std::is_const_v<T>, "Can't patch a const object.");
+
+            constexpr Category c = classify_opt<T>;
+
+            if constexpr (c == Category::adjust)
+            {
+                // Adjustment doesn't produce any path steps.
+                if constexpr (std::is_lvalue_reference_v<Adjust::AdjustedType<T &>>)
+                    (ApplyLow)(Adjust::Adjust(value), op, step_index);
+                else
+                    ThrowBadPath(op, step_index, "this type is adjusted to a temporary, which can't be modified");
+                return;
+            }
+
+            if (step_index == op.path.size())
+            {
+                if (op.kind == PatchOpKind::replace)
+                {
+                    Binary::FromBytes(value, op.value);
+                }
+                else if (op.kind == PatchOpKind::resize)
+                {
+                    if constexpr (ResizableRange<T>)
+                        value.resize(std::size_t(op.size));
+                    else
+                        ThrowBadPath(op, step_index, "this type can't be resized");
+                }
+                else
+                {
+                    ThrowBadPath(op, step_index, "unknown operation");
+                }
+                return;
+            }
+
+            const PatchStep &step = op.path[step_index];
+
+            if constexpr (c == Category::indirect)
+            {
+                if (step.kind != PatchStepKind::value)
+                    ThrowBadPath(op, step_index, "expected an indirect type");
+                if constexpr (!Indirect::AlwaysHasValue<T>)
+                {
+                    if (!Indirect::HasValue(value))
+                        ThrowBadPath(op, step_index, "the indirect type has no value");
+                }
+                (ApplyLow)(Indirect::GetValue(value), op, step_index + 1);
+            }
+            else if constexpr (c == Category::structure)
+            {
+                if (step.kind != PatchStepKind::member && step.kind != PatchStepKind::base)
+                    ThrowBadPath(op, step_index, "expected a struct");
+
+                std::uint64_t base_index = 0;
+                bool found = (VisitMembers<Meta::LoopAnyOf<>, IterationFlags{}, Mode>)(value, [&]<VisitDesc Desc>(auto &member) -> bool
+                {
+                    if constexpr (std::derived_from<Desc, VisitingAnyBase>)
+                    {
+                        if (step.kind != PatchStepKind::base || step.index != base_index++)
+                            return false;
+                    }
+                    else
+                    {
+                        if (step.kind != PatchStepKind::member || step.index != std::uint64_t(Desc::value))
+                            return false;
+                    }
+                    (ApplyLow<Desc::mode>)(member, op, step_index + 1);
+                    return true;
+                });
+                if (!found)
+                    ThrowBadPath(op, step_index, "the member or base index is out of range");
+            }
+            else if constexpr (c == Category::range)
+            {
+                if (step.kind != PatchStepKind::element)
+                    ThrowBadPath(op, step_index, "expected a range");
+                if constexpr (ElementwiseDiffableRange<T>)
+                {
+                    if (step.index >= std::uint64_t(std::ranges::size(value)))
+                        ThrowBadPath(op, step_index, "the element index is out of range");
+                    (ApplyLow)(*std::ranges::next(std::ranges::begin(value), std::ranges::range_difference_t<T>(step.index)), op, step_index + 1);
+                }
+                else
+                {
+                    ThrowBadPath(op, step_index, "this range doesn't support random access");
+                }
+            }
+            else if constexpr (c == Category::variant)
+            {
+                if (step.kind != PatchStepKind::alternative)
+                    ThrowBadPath(op, step_index, "expected a variant");
+                if (step.index != value.index())
+                    ThrowBadPath(op, step_index, "the variant holds a different alternative");
+                (VisitMembers<Meta::LoopSimple>)(value, [&]<VisitDesc Desc>(auto &alt){(ApplyLow<Desc::mode>)(alt, op, step_index + 1);});
+            }
+            else
+            {
+                ThrowBadPath(op, step_index, "this type has no subobjects");
+            }
+        }
+    }
+
+    // Computes the patch that turns `old_value` into `new_value`.
+    template <Meta::Deduce..., typename T>
+    [[nodiscard]] Patch Diff(const T &old_value, const T &new_value)
+    {
+        Patch ret;
+        detail::Diff::Context ctx{.patch = ret, .path = {}};
+        (detail::Diff::DiffLow)(ctx, old_value, new_value);
+        return ret;
+    }
+
+    // Applies a patch produced by `Diff()`. `value` should be equal to the old value passed to `Diff()`.
+    // Throws if the patch doesn't match the structure of `value`. In that case the operations before the failing one remain applied.
+    template <Meta::Deduce..., typename T>
+    void ApplyPatch(T &value, const Patch &patch)
+    {
+        for (const PatchOp &op : patch.ops)
+            (detail::Diff::ApplyLow)(value, op, 0);
+    }
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "em/macros/utils/forward.h"
+#include "em/meta/common.h"
+#include "em/refl/classify.h"
+#include "em/refl/common.h"
+#include "em/refl/macros/dirty.h"
+#include "em/refl/macros/structs.h"
+#include "em/refl/recursively_visit_types.h"
+#include "em/refl/visit_members.h"
+
+#include <bitset>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+
+// Dirty tracking for `EM_REFL()` structs.
+// Put `EM_DIRTY_TRACKING` before the members in `EM_REFL()`, and the struct gets a bitset with one bit per non-static member.
+// `Structs::GetMemberMutable()` on a non-const object (and everything built on top of it, such as `VisitMembers()`) sets the bit of that member,
+//   while `Structs::GetMemberConst()` and the getters called on const objects don't.
+// Then `RecursivelyVisitDirtyElemsMatchingPred()` only descends into the dirty members of such structs, skipping the clean subtrees entirely.
+//
+// Things to keep in mind:
+// * Writing to the fields directly, without the reflection getters, bypasses tracking. Use `MarkMemberDirty()` in that case.
+// * A nested struct is only reached if its parent member is dirty too, so access the nested objects through the getters starting from the root.
+// * Pass const objects to the read-only visitors, otherwise they mark everything they visit as dirty.
+// * The bits are copied along with the object, and aren't reflected, so they don't affect serialization, hashing, comparison, etc.
+
+// `EM_DIRTY_TRACKING` itself is in `em/refl/macros/dirty.h`.
+
+namespace em::Refl
+{
+    // Whether `T` uses `EM_DIRTY_TRACKING`. Cvref-qualifiers are ignored.
+    template <typename T>
+    concept HasDirtyTracking = requires(const std::remove_cvref_t<T> *p){_adl_em_refl_DirtyBits(custom::AdlDummy{}, p);};
+
+    // Returns the dirty bits of `object`, one per non-static member, in the same order as the member indices.
+    template <Meta::Deduce..., HasDirtyTracking T>
+    [[nodiscard]] constexpr const auto &DirtyMembers(const T &object)
+    {
+        return _adl_em_refl_DirtyBits(custom::AdlDummy{}, &object);
+    }
+
+    // Returns true if the `I`th non-static member of `object` was accessed mutably since the bits were last cleared.
+    template <int I, Meta::Deduce..., HasDirtyTracking T> requires Structs::ValidMemberIndex<T, I>
+    [[nodiscard]] constexpr bool IsMemberDirty(const T &object)
+    {
+        return DirtyMembers(object).test(std::size_t(I));
+    }
+
+    // Marks the `I`th non-static member as dirty. Use this if you modify a field directly, bypassing the getters.
+    template <int I, Meta::Deduce..., HasDirtyTracking T> requires Structs::ValidMemberIndex<T, I>
+    constexpr void MarkMemberDirty(T &object)
+    {
+        _adl_em_refl_DirtyBits(custom::AdlDummy{}, &object).set(std::size_t(I));
+    }
+
+    // Clears the dirty bits of `object` itself, but not of the nested objects. See `ClearDirtyRecursively()`.
+    template <Meta::Deduce..., HasDirtyTracking T>
+    constexpr void ClearDirtyMembers(T &object)
+    {
+        _adl_em_refl_DirtyBits(custom::AdlDummy{}, &object).reset();
+    }
+
+    namespace detail::Dirty
+    {
+        struct PredHasDirtyTracking
+        {
+            template <typename T>
+            using type = std::bool_constant<HasDirtyTracking<T>>;
+        };
+
+        // This mirrors `RecursivelyVisitElemsMatchingPred()`, see that for the explanation of the flags.
+        // If `Clear` is true, clears the dirty bits of every visited struct after visiting its members.
+        template <bool Clear, Meta::TypePredicate Pred, IterationFlags Flags, VisitMode Mode, Meta::Deduce..., typename T, typename F>
+        constexpr void VisitLow(T &&input, F &func)
+        {
+            static constexpr bool is_new_instance = !(Mode == VisitMode::base_subobject && bool(Flags & IterationFlags::predicate_finds_bases));
+
+            static constexpr IterationFlags next_flags = is_new_instance ? Flags & ~IterationFlags::ignore_root : Flags;
+
+            static constexpr IterationFlags next_flags_base = []{
+                if constexpr (bool(Flags & IterationFlags::predicate_finds_bases) && !bool(Flags & IterationFlags::ignore_root))
+                    return next_flags | IterationFlags::ignore_root * Pred::template type<T &&>::value;
+                else
+                    return next_flags;
+            }();
+
+            if constexpr (!bool(Flags & IterationFlags::ignore_root) && Pred::template type<T &&>::value)
+                func(EM_FWD(input));
+
+            if constexpr (TypeRecursivelyContainsPred<T, Pred>)
+            {
+                auto visit_member = [&]<VisitDesc Desc>(auto &&member)
+                {
+                    static constexpr IterationFlags cur_flags = std::derived_from<VisitingAnyBase, Desc> ? next_flags_base : next_flags;
+
+                    (VisitLow<Clear, Pred, cur_flags, Desc::mode>)(EM_FWD(member), func);
+                };
+
+                if constexpr (classify_opt<T> == Category::structure && HasDirtyTracking<T>)
+                {
+                    constexpr bool is_mutable = !std::is_const_v<std::remove_reference_t<T>>;
+                    static_assert(is_mutable || !Clear, "Can't clear the dirty bits of a const object.");
+
+                    // Visiting the members mutably marks them all as dirty, so we save the bits and restore them afterwards.
+                    // Only our own members are affected, `func` is only called on the nested objects and can't access this one.
+                    const auto saved_bits = DirtyMembers(input);
+
+                    (VisitMembers<Meta::LoopSimple, Flags, Mode>)(input, [&]<VisitDesc Desc>(auto &&member)
+                    {
+                        // The bases have their own bits, if any.
+                        if constexpr (std::derived_from<Desc, VisitingSomeClassMember>)
+                        {
+                            if (!saved_bits.test(std::size_t(Desc::value)))
+                                return;
+                        }
+                        visit_member.template operator()<Desc>(EM_FWD(member));
+                    });
+
+                    if constexpr (Clear)
+                        ClearDirtyMembers(input);
+                    else if constexpr (is_mutable)
+                        _adl_em_refl_DirtyBits(custom::AdlDummy{}, &input) = saved_bits;
+                }
+                else
+                {
+                    (VisitMembers<Meta::LoopSimple, Flags, Mode>)(EM_FWD(input), visit_member);
+                }
+            }
+        }
+    }
+
+    // Like `RecursivelyVisitElemsMatchingPred()` with the default loop backend (so pre-order), but skips the clean members of the `EM_DIRTY_TRACKING` structs,
+    //   along with everything nested in them.
+    // Everything else is visited as usual, e.g. all elements of a dirty vector are visited (but the nested structs with dirty tracking can still skip their members).
+    // This doesn't change the dirty bits. Call `ClearDirtyRecursively()` afterwards if needed.
+    template <Meta::TypePredicate Pred, IterationFlags Flags = {}, VisitMode Mode = VisitMode::normal, Meta::Deduce..., typename T, typename F>
+    constexpr void RecursivelyVisitDirtyElemsMatchingPred(T &&input, F &&func)
+    {
+        (detail::Dirty::VisitLow<false, Pred, Flags, Mode>)(EM_FWD(input), func);
+    }
+
+    // Same, but visits the instances of `Elem`, like `RecursivelyVisitElemsOfTypeCvref()`.
+    template <typename Elem, IterationFlags Flags = {}, VisitMode Mode = VisitMode::normal, Meta::Deduce..., typename T, typename F>
+    constexpr void RecursivelyVisitDirtyElemsOfTypeCvref(T &&input, F &&func)
+    {
+        (RecursivelyVisitDirtyElemsMatchingPred<PredTypeMatchesElemCvref<Elem>, Flags | IterationFlags::predicate_finds_bases, Mode>)(EM_FWD(input), EM_FWD(func));
+    }
+
+    // Clears the dirty bits in `object` and in all nested objects with dirty tracking. Only descends into the dirty members, since the clean ones have nothing to clear.
+    template <Meta::Deduce..., typename T>
+    constexpr void ClearDirtyRecursively(T &object)
+    {
+        static_assert(!std::is_const_v<T>, "Can't clear the dirty bits of a const object.");
+        auto func = [](auto &&){};
+        (detail::Dirty::VisitLow<true, detail::Dirty::PredHasDirtyTracking, IterationFlags{}, VisitMode::normal>)(object, func);
+    }
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "em/meta/common.h"
+#include "em/meta/const_for.h"
+#include "em/meta/type_name.h"
+#include "em/refl/bulk_copyable.h"
+#include "em/refl/classify.h"
+#include "em/refl/common.h"
+#include "em/refl/visit_types.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+// Compile-time schema fingerprints of reflected types.
+// `schema_fingerprint<T>` is a 64-bit hash of everything that affects how `T` is serialized, plus the member names and attributes.
+// It's computed recursively from the member names, types and attributes, the bases, the variant alternatives, the range and optional element types,
+//   and the kinds and sizes of the scalars. The enum names and the struct names (including the base names) are not included, so renaming them is fine.
+// The bases are identified by their position among the bases, since the type names aren't stable across compilers and namespaces.
+// If the fingerprints of two types are equal, then (barring hash collisions) they have the same `em/refl/serialize/binary.h` representation
+//   and the same member names, so the data can be loaded from one into the other as is.
+//
+// This is used by `em/refl/serialize/versioned.h` to skip the conversion when the data was written with the same schema.
+
+namespace em::Refl
+{
+    // The kinds of nodes in a schema. See `em/refl/serialize/versioned.h` for how those are serialized.
+    enum class SchemaKind : std::uint8_t
+    {
+        signed_int,
+        unsigned_int,
+        floating,
+        boolean,
+        array, // A fixed-size `BulkCopyable` array, without a size prefix.
+        structure, // The children are the bases and the members, in the `VisitTypes()` order.
+        range,
+        nullable, // A nullable indirect type, such as `std::optional`.
+        variant,
+        recursive, // A reference to one of the enclosing types, this is only used in the fingerprints.
+    };
+
+    namespace detail::Fingerprint
+    {
+        // Strips the things that don't affect the serialized representation: cvref-qualifiers, adjustments, and non-nullable indirection.
+        template <typename T>
+        struct Canonical {using type = std::remove_cvref_t<T>;};
+        template <typename T> requires Adjust::NeedsAdjustment<std::remove_cvref_t<T>>
+        struct Canonical<T> : Canonical<Adjust::AdjustedType<std::remove_cvref_t<T> &>> {};
+        template <typename T> requires(!Adjust::NeedsAdjustment<std::remove_cvref_t<T>> && classify_opt<std::remove_cvref_t<T>> == Category::indirect && Indirect::AlwaysHasValue<std::remove_cvref_t<T>>)
+        struct Canonical<T> : Canonical<Indirect::ValueTypeCvref<std::remove_cvref_t<T> &>> {};
+
+        // Returns the schema kind of a canonical type.
+        template <typename T>
+        [[nodiscard]] constexpr SchemaKind GetKind()
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                return SchemaKind::boolean;
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                return GetKind<std::underlying_type_t<T>>();
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                return SchemaKind::floating;
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                return std::is_signed_v<T> ? SchemaKind::signed_int : SchemaKind::unsigned_int;
+            }
+            else if constexpr (std::is_array_v<T> && BulkCopyable<T>)
+            {
+                return SchemaKind::array;
+            }
+            else
+            {
+                constexpr Category c = classify_opt<T>;
+                if constexpr (c == Category::structure)
+                    return SchemaKind::structure;
+                else if constexpr (c == Category::range)
+                    return SchemaKind::range;
+                else if constexpr (c == Category::indirect)
+                    return SchemaKind::nullable;
+                else if constexpr (c == Category::variant)
+                    return SchemaKind::variant;
+                else
+                    static_assert(Meta::always_false<T>, "Don't know how to describe the schema of this type.");
+            }
+        }
+
+        // Returns the member name, or empty if the struct has no member names, or if this is a base.
+        template <typename Desc>
+        [[nodiscard]] constexpr std::string_view ChildName()
+        {
+            if constexpr (std::derived_from<Desc, VisitingAnyBase>)
+                return {};
+            else if constexpr (Structs::HasMemberNames<typename Desc::type>)
+                return Structs::GetMemberName<typename Desc::type>(Desc::value);
+            else
+                return {};
+        }
+
+        [[nodiscard]] constexpr std::uint64_t Combine(std::uint64_t a, std::uint64_t b)
+        {
+            return Structs::detail::MixHash(std::rotl(a, 17) ^ b);
+        }
+
+        template <typename List>
+        struct HashAttributes {};
+        template <typename ...A>
+        struct HashAttributes<Meta::TypeList<A...>>
+        {
+            static constexpr std::uint64_t value = []{
+                std::uint64_t ret = sizeof...(A);
+                ((ret = Combine(ret, Structs::detail::HashName(Meta::TypeName<A>()))), ...);
+                return ret;
+            }();
+        };
+
+        // How far `T` is from the end of `Stack...` (0 for the last element), or -1 if it's not there.
+        template <typename T, typename ...Stack>
+        constexpr int stack_depth = []{
+            constexpr bool matches[] = {std::is_same_v<T, Stack>..., false};
+            for (int i = int(sizeof...(Stack)) - 1; i >= 0; i--)
+            {
+                if (matches[i])
+                    return int(sizeof...(Stack)) - 1 - i;
+            }
+            return -1;
+        }();
+
+        // `Stack...` are the enclosing types, to detect recursion.
+        template <typename T, VisitMode Mode, typename ...Stack>
+        [[nodiscard]] constexpr std::uint64_t FingerprintLow()
+        {
+            using U = typename Canonical<T>::type;
+            constexpr SchemaKind kind = GetKind<U>();
+
+            if constexpr (kind == SchemaKind::structure && stack_depth<U, Stack...> != -1)
+            {
+                return Combine(std::uint64_t(SchemaKind::recursive), std::uint64_t(stack_depth<U, Stack...>));
+            }
+            else
+            {
+                // The containers don't depend on `sizeof`, since it doesn't affect their serialized representation.
+                constexpr bool is_container = kind == SchemaKind::range || kind == SchemaKind::nullable || kind == SchemaKind::variant;
+                std::uint64_t ret = Combine(std::uint64_t(kind), is_container ? 0 : sizeof(U));
+
+                if constexpr (kind == SchemaKind::array)
+                {
+                    ret = Combine(ret, std::extent_v<U>);
+                    ret = Combine(ret, FingerprintLow<std::remove_extent_t<U>, VisitMode::normal, Stack...>());
+                }
+                else if constexpr (kind == SchemaKind::structure)
+                {
+                    (VisitTypes<U, Meta::LoopSimple, Mode>)([&]<typename SubT, VisitDesc Desc>
+                    {
+                        ret = Combine(ret, std::derived_from<Desc, VisitingAnyBase>);
+                        ret = Combine(ret, Structs::detail::HashName(ChildName<Desc>()));
+                        if constexpr (std::derived_from<Desc, VisitingSomeClassMember>)
+                            ret = Combine(ret, HashAttributes<Structs::MemberAttributes<typename Desc::type, Desc::value>>::value);
+                        ret = Combine(ret, FingerprintLow<SubT, Desc::mode, Stack..., U>());
+                    });
+                }
+                else if constexpr (is_container)
+                {
+                    (VisitTypes<U, Meta::LoopSimple>)([&]<typename SubT, VisitDesc Desc>
+                    {
+                        ret = Combine(ret, FingerprintLow<SubT, Desc::mode, Stack..., U>());
+                    });
+                }
+
+                return ret;
+            }
+        }
+    }
+
+    // The schema fingerprint of `T`, see above. Cvref-qualifiers are ignored.
+    // `Mode` is the mode in which `T` is visited, it matters for the classes with virtual bases.
+    template <typename T, VisitMode Mode = VisitMode::normal>
+    constexpr std::uint64_t schema_fingerprint = detail::Fingerprint::FingerprintLow<T, Mode>();
+}
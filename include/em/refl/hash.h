@@ -0,0 +1,229 @@
+#pragma once
+
+#include "em/meta/common.h"
+#include "em/refl/bulk_copyable.h"
+#include "em/refl/classify.h"
+#include "em/refl/common.h"
+#include "em/refl/visit_members.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <type_traits>
+
+// Structural hashing of reflected types.
+// `Hash(value)` visits the object the same way the binary serializer does (see `em/refl/serialize/binary.h`), and hashes the leaf elements.
+// Range sizes, variant indices and the presence of values in nullable indirect types are hashed too, so e.g. `{{1},{}}` and `{{},{1}}` hash differently.
+//
+// The subtrees that are `BulkCopyable` and the contiguous ranges of those are hashed as single blocks of bytes, which is much faster for large arrays.
+// Because of that we hash the object representation, so e.g. `0.0` and `-0.0` hash differently, as do NaNs with different payloads.
+// The ranges are hashed in their iteration order, so the unordered containers don't produce stable hashes.
+
+namespace em::Refl
+{
+    // Put this attribute on `EM_REFL()` members to exclude them from `Hash()`.
+    struct HashIgnore : BasicAttribute {};
+
+    // A streaming 64-bit hash. The block function is XXH64, which processes 32 bytes per iteration in 4 independent lanes,
+    //   so the compiler can interleave or vectorize them.
+    // The result doesn't depend on how the input is split into calls.
+    class Hasher
+    {
+        static constexpr std::uint64_t prime1 = 0x9e3779b185ebca87;
+        static constexpr std::uint64_t prime2 = 0xc2b2ae3d27d4eb4f;
+        static constexpr std::uint64_t prime3 = 0x165667b19e3779f9;
+        static constexpr std::uint64_t prime4 = 0x85ebca77c2b2ae63;
+        static constexpr std::uint64_t prime5 = 0x27d4eb2f165667c5;
+
+        std::uint64_t lanes[4]{};
+        unsigned char buffer[32]{};
+        std::size_t buffer_size = 0;
+        std::uint64_t total_size = 0;
+        std::uint64_t seed = 0;
+
+        [[nodiscard]] static std::uint64_t Round(std::uint64_t acc, std::uint64_t input)
+        {
+            return std::rotl(acc + input * prime2, 31) * prime1;
+        }
+
+        [[nodiscard]] static std::uint64_t MergeRound(std::uint64_t acc, std::uint64_t lane)
+        {
+            return (acc ^ Round(0, lane)) * prime1 + prime4;
+        }
+
+        template <typename T>
+        [[nodiscard]] static T Load(const unsigned char *data)
+        {
+            T ret;
+            std::memcpy(&ret, data, sizeof(T));
+            return ret;
+        }
+
+        // Consumes whole 32-byte blocks from `data`, returns the number of bytes consumed.
+        std::size_t ConsumeBlocks(const unsigned char *data, std::size_t size)
+        {
+            // Copying the lanes to locals helps the optimizer keep them in registers.
+            std::uint64_t l0 = lanes[0], l1 = lanes[1], l2 = lanes[2], l3 = lanes[3];
+            std::size_t i = 0;
+            for (; i + 32 <= size; i += 32)
+            {
+                l0 = Round(l0, Load<std::uint64_t>(data + i));
+                l1 = Round(l1, Load<std::uint64_t>(data + i + 8));
+                l2 = Round(l2, Load<std::uint64_t>(data + i + 16));
+                l3 = Round(l3, Load<std::uint64_t>(data + i + 24));
+            }
+            lanes[0] = l0; lanes[1] = l1; lanes[2] = l2; lanes[3] = l3;
+            return i;
+        }
+
+      public:
+        explicit Hasher(std::uint64_t seed = 0)
+            : lanes{seed + prime1 + prime2, seed + prime2, seed, seed - prime1}, seed(seed)
+        {}
+
+        // Appends bytes to the input. This makes this an `Output` for the binary serializer too.
+        void operator()(const void *data, std::size_t size)
+        {
+            if (size == 0)
+                return; // `data` can be null here, e.g. for empty vectors.
+
+            const unsigned char *bytes = static_cast<const unsigned char *>(data);
+            total_size += size;
+
+            if (buffer_size > 0)
+            {
+                std::size_t n = std::min(size, sizeof(buffer) - buffer_size);
+                std::memcpy(buffer + buffer_size, bytes, n);
+                buffer_size += n;
+                bytes += n;
+                size -= n;
+                if (buffer_size < sizeof(buffer))
+                    return;
+                ConsumeBlocks(buffer, sizeof(buffer));
+                buffer_size = 0;
+            }
+
+            std::size_t consumed = ConsumeBlocks(bytes, size);
+            std::memcpy(buffer, bytes + consumed, size - consumed);
+            buffer_size = size - consumed;
+        }
+
+        // Returns the hash of everything appended so far. Can be called several times.
+        [[nodiscard]] std::uint64_t Digest() const
+        {
+            std::uint64_t h;
+            if (total_size >= 32)
+            {
+                h = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+                for (std::uint64_t lane : lanes)
+                    h = MergeRound(h, lane);
+            }
+            else
+            {
+                h = seed + prime5;
+            }
+
+            h += total_size;
+
+            std::size_t i = 0;
+            for (; i + 8 <= buffer_size; i += 8)
+                h = std::rotl(h ^ Round(0, Load<std::uint64_t>(buffer + i)), 27) * prime1 + prime4;
+            if (i + 4 <= buffer_size)
+            {
+                h = std::rotl(h ^ (Load<std::uint32_t>(buffer + i) * prime1), 23) * prime2 + prime3;
+                i += 4;
+            }
+            for (; i < buffer_size; i++)
+                h = std::rotl(h ^ (buffer[i] * prime5), 11) * prime1;
+
+            h ^= h >> 33;
+            h *= prime2;
+            h ^= h >> 29;
+            h *= prime3;
+            h ^= h >> 32;
+            return h;
+        }
+    };
+
+    namespace detail::Hash
+    {
+        template <VisitMode Mode = VisitMode::normal, Meta::Deduce..., typename T>
+        void HashLow(Hasher &hasher, const T &value)
+        {
+            constexpr Category c = classify_opt<T>;
+
+            if constexpr (BulkCopyable<T, HashIgnore>)
+            {
+                hasher(&value, sizeof(T));
+            }
+            else if constexpr (c == Category::indirect && !Indirect::AlwaysHasValue<T>)
+            {
+                const unsigned char has_value = Indirect::HasValue(value);
+                hasher(&has_value, 1);
+                if (has_value)
+                    (HashLow)(hasher, Indirect::GetValue(value));
+            }
+            else if constexpr (c == Category::range)
+            {
+                const std::uint64_t size = std::uint64_t(std::ranges::distance(value));
+                hasher(&size, sizeof(size));
+
+                if constexpr (ContiguousBulkRange<const T, HashIgnore>)
+                    hasher(std::ranges::data(value), std::size_t(size) * sizeof(std::ranges::range_value_t<T>));
+                else
+                    (VisitMembers<Meta::LoopSimple>)(value, [&]<VisitDesc Desc>(const auto &elem){(HashLow<Desc::mode>)(hasher, elem);});
+            }
+            else if constexpr (c == Category::variant)
+            {
+                const std::uint32_t index = std::uint32_t(value.index());
+                hasher(&index, sizeof(index));
+                (VisitMembers<Meta::LoopSimple>)(value, [&]<VisitDesc Desc>(const auto &alt){(HashLow<Desc::mode>)(hasher, alt);});
+            }
+            else if constexpr (c != Category::unknown)
+            {
+                (VisitMembers<Meta::LoopSimple, IterationFlags{}, Mode>)(value, [&]<VisitDesc Desc>(const auto &member)
+                {
+                    if constexpr (std::derived_from<Desc, VisitingSomeClassMember>)
+                    {
+                        if constexpr (Structs::member_has_attribute<typename Desc::type, Desc::value, HashIgnore>)
+                            return;
+                    }
+                    (HashLow<Desc::mode>)(hasher, member);
+                });
+            }
+            else
+            {
+                static_assert(Meta::always_false<T>, "Don't know how to hash this type.");
+            }
+        }
+    }
+
+    // Appends `value` to the `hasher`. Use this to combine several objects into one hash.
+    template <Meta::Deduce..., typename T>
+    void HashAppend(Hasher &hasher, const T &value)
+    {
+        (detail::Hash::HashLow)(hasher, value);
+    }
+
+    // Returns the structural hash of `value`. Members with the `HashIgnore` attribute are skipped.
+    template <Meta::Deduce..., typename T>
+    [[nodiscard]] std::uint64_t Hash(const T &value, std::uint64_t seed = 0)
+    {
+        Hasher hasher(seed);
+        (HashAppend)(hasher, value);
+        return hasher.Digest();
+    }
+
+    // A hash functor for the standard containers, e.g. `std::unordered_map<Key, Value, Refl::StdHash>`.
+    struct StdHash
+    {
+        template <typename T>
+        [[nodiscard]] std::size_t operator()(const T &value) const
+        {
+            return std::size_t(Hash(value));
+        }
+    };
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "em/macros/meta/common.h"
+#include "em/macros/meta/if_else.h"
+#include "em/macros/utils/forward.h"
+#include "em/refl/common.h"
+#include "em/refl/macros/structs.h"
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Hot/cold splitting of `EM_REFL()` structs.
+// Put `EM_HOT_COLD_SPLIT` before the members in `EM_REFL()`, then mark the rarely used members with `EM_COLD` (and switch back with `EM_HOT`),
+//   the same way you'd use access specifiers:
+//
+//     struct A
+//     {
+//         EM_REFL(
+//             EM_HOT_COLD_SPLIT
+//             (int)(x)
+//             (int)(y)
+//           EM_COLD
+//             (std::string)(description)
+//             (std::vector<int>)(history)
+//         )
+//     };
+//
+// The cold non-static members are moved to a separately allocated block, and the struct only stores a pointer to it.
+// They get the `Cold` attribute, and otherwise keep their indices, names and types, so the reflection API sees the same struct as before.
+// The block is allocated on the first mutable access to any cold member. Until then (and after being moved from) the cold members have their default values.
+// The cold members can't be accessed by name directly, use the reflection getters.
+//
+// Since the members are no longer stored inline, `Structs::MemberLayout()` isn't available for such structs, and they aren't `BulkCopyable`.
+// Static members are left alone, even if marked as cold.
+
+// The control statement, place it at the beginning of `EM_REFL()`.
+#define EM_HOT_COLD_SPLIT EM_REFL_PREPROCESS_LOW(DETAIL_EM_HOT_COLD_BODY, DETAIL_EM_HOT_COLD_STEP, DETAIL_EM_HOT_COLD_FINAL, (0/*is cold*/, /*cold fields*/))
+
+// Mark the following members as cold or hot (which is the default). Those require `EM_HOT_COLD_SPLIT`.
+#define EM_COLD EM_REFL_ANNOTATE_LOW(hot_cold, "`EM_COLD` requires `EM_HOT_COLD_SPLIT` at the beginning of `EM_REFL()`.", 1)
+#define EM_HOT EM_REFL_ANNOTATE_LOW(hot_cold, "`EM_HOT` requires `EM_HOT_COLD_SPLIT` at the beginning of `EM_REFL()`.", 0)
+
+namespace em::Refl
+{
+    // The attribute that `EM_HOT_COLD_SPLIT` adds to the cold members. You don't need to add it manually, it does nothing by itself.
+    struct Cold : BasicAttribute {};
+
+    namespace detail::HotCold
+    {
+        // Owns the block of cold members, and copies it when copied.
+        // Null means that all members have the default values.
+        template <typename C>
+        class ColdPtr
+        {
+            std::unique_ptr<C> ptr;
+
+            static const C &DefaultValue()
+            {
+                static const C ret{};
+                return ret;
+            }
+
+          public:
+            constexpr ColdPtr() = default;
+
+            constexpr ColdPtr(const ColdPtr &other)
+                : ptr(other.ptr ? std::make_unique<C>(*other.ptr) : nullptr)
+            {}
+
+            constexpr ColdPtr(ColdPtr &&other) noexcept = default;
+
+            constexpr ColdPtr &operator=(const ColdPtr &other)
+            {
+                if (!other.ptr)
+                    ptr = nullptr;
+                else if (ptr)
+                    *ptr = *other.ptr;
+                else
+                    ptr = std::make_unique<C>(*other.ptr);
+                return *this;
+            }
+
+            constexpr ColdPtr &operator=(ColdPtr &&other) noexcept = default;
+
+            [[nodiscard]] constexpr const C &Get() const
+            {
+                return ptr ? *ptr : DefaultValue();
+            }
+
+            [[nodiscard]] constexpr C &GetMutable()
+            {
+                if (!ptr)
+                    ptr = std::make_unique<C>();
+                return *ptr;
+            }
+        };
+
+        // Returns the cold members from a `ColdPtr`, with the same constness and value category as `S`.
+        template <typename S, typename P>
+        [[nodiscard]] constexpr auto &&ForwardColdMembers(P &ptr)
+        {
+            auto &members = [&]() -> auto &
+            {
+                if constexpr (std::is_const_v<std::remove_reference_t<S>>)
+                    return ptr.Get();
+                else
+                    return ptr.GetMutable();
+            }();
+
+            if constexpr (std::is_rvalue_reference_v<S &&>)
+                return std::move(members);
+            else
+                return members;
+        }
+    }
+}
+
+// --- Internals:
+
+// The state is `(is_cold_, cold_fields_seq_)`. The cold fields are collected in the same format as they arrive to us,
+//   so we can emit them with `DETAIL_EM_REFL_EMIT_MEMBERS()` in the end.
+
+// Here we expand `d` to `is_cold_, cold_fields_` and dispatch on the entry kind.
+#define DETAIL_EM_HOT_COLD_BODY(n, d, kind_, ...) DETAIL_EM_HOT_COLD_BODY_1(kind_, EM_IDENTITY d, __VA_ARGS__)
+#define DETAIL_EM_HOT_COLD_BODY_1(kind_, ...) EM_CAT(DETAIL_EM_HOT_COLD_BODY_, kind_)(__VA_ARGS__)
+#define DETAIL_EM_HOT_COLD_BODY_field(is_cold_, cold_fields_, static_, p_type_attrs_, p_decl_seq_verbatim_, .../*name_, init_...*/) \
+    EM_IF_CAT_ADDS_COMMA(DETAIL_EM_HOT_COLD_CHECK_STATIC_, static_) \
+        ((field, static_, p_type_attrs_, p_decl_seq_verbatim_, __VA_ARGS__)) \
+        (EM_IF_01(is_cold_) \
+            ((indirect_field, (EM_IDENTITY p_type_attrs_, ::em::Refl::Cold), (_em_Self::_em_GetColdMembers(EM_FWD(_em_self)).EM_VA_FIRST(__VA_ARGS__)), EM_VA_FIRST(__VA_ARGS__))) \
+            ((field, static_, p_type_attrs_, p_decl_seq_verbatim_, __VA_ARGS__)) \
+        )
+#define DETAIL_EM_HOT_COLD_BODY_indirect_field(is_cold_, cold_fields_, ...) (indirect_field, __VA_ARGS__)
+#define DETAIL_EM_HOT_COLD_BODY_verbatim(is_cold_, cold_fields_, ...) (verbatim, __VA_ARGS__)
+// Remove our own annotations, leave the rest.
+#define DETAIL_EM_HOT_COLD_BODY_annotation(is_cold_, cold_fields_, category_, ...) \
+    EM_IF_CAT_ADDS_COMMA(DETAIL_EM_HOT_COLD_CHECK_CATEGORY_, category_)()((annotation, category_, __VA_ARGS__))
+
+#define DETAIL_EM_HOT_COLD_STEP(n, d, kind_, ...) (DETAIL_EM_HOT_COLD_STEP_1(kind_, EM_IDENTITY d, __VA_ARGS__))
+#define DETAIL_EM_HOT_COLD_STEP_1(kind_, ...) EM_CAT(DETAIL_EM_HOT_COLD_STEP_, kind_)(__VA_ARGS__)
+#define DETAIL_EM_HOT_COLD_STEP_field(is_cold_, cold_fields_, static_, ...) \
+    is_cold_, \
+    cold_fields_ EM_IF_CAT_ADDS_COMMA(DETAIL_EM_HOT_COLD_CHECK_STATIC_, static_)()(EM_IF_01(is_cold_)((field, static_, __VA_ARGS__))())
+#define DETAIL_EM_HOT_COLD_STEP_indirect_field(is_cold_, cold_fields_, ...) is_cold_, cold_fields_
+#define DETAIL_EM_HOT_COLD_STEP_verbatim(is_cold_, cold_fields_, ...) is_cold_, cold_fields_
+#define DETAIL_EM_HOT_COLD_STEP_annotation(is_cold_, cold_fields_, category_, error_if_unused_, ...) \
+    EM_IF_CAT_ADDS_COMMA(DETAIL_EM_HOT_COLD_CHECK_CATEGORY_, category_)(__VA_ARGS__)(is_cold_), cold_fields_
+
+#define DETAIL_EM_HOT_COLD_CHECK_STATIC_static ,
+#define DETAIL_EM_HOT_COLD_CHECK_CATEGORY_hot_cold ,
+
+#define DETAIL_EM_HOT_COLD_FINAL(n, d) DETAIL_EM_HOT_COLD_FINAL_2(EM_IDENTITY d)
+#define DETAIL_EM_HOT_COLD_FINAL_2(...) DETAIL_EM_HOT_COLD_FINAL_3(__VA_ARGS__)
+#define DETAIL_EM_HOT_COLD_FINAL_3(is_cold_, cold_fields_) \
+    (verbatim, body, hot_cold_split,, \
+        struct _em_ColdMembers \
+        { \
+            DETAIL_EM_REFL_EMIT_MEMBERS(cold_fields_) \
+        }; \
+        ::em::Refl::detail::HotCold::ColdPtr<_em_ColdMembers> _em_cold; \
+        template <typename _em_S> \
+        [[nodiscard]] static constexpr auto &&_em_GetColdMembers(_em_S &&_em_s) \
+        { \
+            return ::em::Refl::detail::HotCold::ForwardColdMembers<_em_S>(_em_s._em_cold); \
+        } \
+    )
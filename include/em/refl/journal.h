@@ -0,0 +1,388 @@
+#pragma once
+
+#include "em/meta/common.h"
+#include "em/refl/access/structs.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// An undo-redo journal for mutations done through the reflection API.
+// Get the mutable subobjects through `Journal::GetMemberMutable()` (or call `Journal::Record()` before modifying any object),
+//   and the journal saves their old values, then `Undo()` and `Redo()` swap the saved values with the current ones.
+// The mutations are grouped into steps with `Commit()`.
+//
+// The memory usage is proportional to the size of the recorded subobjects, not of the whole document, so record the smallest subobjects you're going to modify
+//   (e.g. individual vector elements rather than the whole vector, unless you're resizing it).
+// The saved values are stored in an arena that's reused after undoing and then making new changes.
+//
+// The recorded objects must not be destroyed or moved in memory while the journal refers to them.
+// In particular, don't record the elements of a container and then resize it in the same step, unless the container itself was recorded before them.
+
+namespace em::Refl
+{
+    namespace detail::Journal
+    {
+        // A simple bump allocator that can roll back to a previous position.
+        class Arena
+        {
+            struct Block
+            {
+                std::unique_ptr<unsigned char[]> data;
+                std::size_t size = 0;
+            };
+
+            static constexpr std::size_t default_block_size = 64 * 1024;
+
+            std::vector<Block> blocks;
+            std::size_t num_used_blocks = 0;
+            std::size_t offset = 0; // In the last used block.
+
+          public:
+            struct Mark
+            {
+                std::size_t num_used_blocks = 0;
+                std::size_t offset = 0;
+            };
+
+            [[nodiscard]] void *Allocate(std::size_t size, std::size_t alignment)
+            {
+                if (num_used_blocks > 0)
+                {
+                    Block &block = blocks[num_used_blocks - 1];
+                    std::size_t padding = -reinterpret_cast<std::uintptr_t>(block.data.get() + offset) & (alignment - 1);
+                    if (offset + padding + size <= block.size)
+                    {
+                        void *ret = block.data.get() + offset + padding;
+                        offset += padding + size;
+                        return ret;
+                    }
+                }
+
+                // Need a new block. Reuse the next one if it's large enough, otherwise replace it.
+                const std::size_t needed_size = size + alignment - 1;
+                if (num_used_blocks == blocks.size() || blocks[num_used_blocks].size < needed_size)
+                {
+                    std::size_t new_size = std::max(default_block_size, needed_size);
+                    blocks.erase(blocks.begin() + std::ptrdiff_t(num_used_blocks), blocks.end());
+                    blocks.push_back({std::make_unique_for_overwrite<unsigned char[]>(new_size), new_size});
+                }
+                num_used_blocks++;
+                offset = 0;
+                return Allocate(size, alignment);
+            }
+
+            [[nodiscard]] Mark GetMark() const
+            {
+                return {num_used_blocks, offset};
+            }
+
+            // Frees everything allocated after the `mark` was obtained. Keeps the memory for reuse.
+            void Release(Mark mark)
+            {
+                num_used_blocks = mark.num_used_blocks;
+                offset = mark.offset;
+            }
+
+            [[nodiscard]] std::size_t MemoryUsage() const
+            {
+                std::size_t ret = 0;
+                for (const Block &block : blocks)
+                    ret += block.size;
+                return ret;
+            }
+        };
+
+        // One recorded object.
+        struct Entry
+        {
+            void *target = nullptr;
+            void *saved = nullptr;
+            void (*swap)(void *target, void *saved, std::size_t size) = nullptr;
+            void (*destroy)(void *saved) = nullptr; // Null for trivially copyable types.
+            std::size_t size = 0;
+        };
+
+        inline void SwapBytes(void *target, void *saved, std::size_t size)
+        {
+            std::swap_ranges(static_cast<unsigned char *>(target), static_cast<unsigned char *>(target) + size, static_cast<unsigned char *>(saved));
+        }
+
+        template <typename T>
+        void SwapObjects(void *target, void *saved, std::size_t)
+        {
+            using std::swap;
+            swap(*static_cast<T *>(target), *static_cast<T *>(saved));
+        }
+
+        template <typename T>
+        void DestroyObject(void *saved)
+        {
+            static_cast<T *>(saved)->~T();
+        }
+    }
+
+    class Journal
+    {
+        detail::Journal::Arena arena;
+        std::vector<detail::Journal::Entry> entries;
+
+        struct Step
+        {
+            std::size_t entries_end = 0;
+            detail::Journal::Arena::Mark arena_end;
+        };
+        std::vector<Step> steps;
+
+        // The last `num_undone_steps` elements of `steps` are undone and can be redone.
+        std::size_t num_undone_steps = 0;
+
+        // The address ranges recorded in the current step, `begin -> end`, to avoid recording the same bytes twice.
+        // The ranges nested in others are removed, so both the beginnings and the ends are increasing.
+        std::map<std::uintptr_t, std::uintptr_t> recorded_in_current_step;
+
+        // Whether the range was already saved as a part of some object recorded in the current step.
+        [[nodiscard]] bool AlreadyRecorded(std::uintptr_t begin, std::uintptr_t end) const
+        {
+            auto it = recorded_in_current_step.upper_bound(begin);
+            return it != recorded_in_current_step.begin() && std::prev(it)->second >= end;
+        }
+
+        // Remembers that the range was recorded. It must not be `AlreadyRecorded()`.
+        void AddRecordedRange(std::uintptr_t begin, std::uintptr_t end)
+        {
+            auto it = recorded_in_current_step.lower_bound(begin);
+            while (it != recorded_in_current_step.end() && it->second <= end)
+                it = recorded_in_current_step.erase(it);
+            recorded_in_current_step.emplace_hint(it, begin, end);
+        }
+
+        [[nodiscard]] std::size_t CurrentStepBegin() const
+        {
+            return steps.empty() ? 0 : steps.back().entries_end;
+        }
+
+        // Destroys the entries starting from `begin`, and releases their memory in the arena.
+        void DestroyEntries(std::size_t begin)
+        {
+            for (std::size_t i = begin; i < entries.size(); i++)
+            {
+                if (entries[i].destroy)
+                    entries[i].destroy(entries[i].saved);
+            }
+            entries.erase(entries.begin() + std::ptrdiff_t(begin), entries.end());
+        }
+
+        void DiscardRedoSteps()
+        {
+            if (num_undone_steps == 0)
+                return;
+
+            steps.erase(steps.end() - std::ptrdiff_t(num_undone_steps), steps.end());
+            num_undone_steps = 0;
+            DestroyEntries(CurrentStepBegin());
+            arena.Release(steps.empty() ? detail::Journal::Arena::Mark{} : steps.back().arena_end);
+        }
+
+        // Swaps the saved values with the current ones for the entries in `[begin, end)` matching `pred`, in reverse order if `reverse` is true.
+        void SwapEntries(std::size_t begin, std::size_t end, bool reverse, auto &&pred)
+        {
+            for (std::size_t i = 0; i < end - begin; i++)
+            {
+                detail::Journal::Entry &e = entries[reverse ? end - 1 - i : begin + i];
+                if (pred(e))
+                    e.swap(e.target, e.saved, e.size);
+            }
+        }
+
+        // Swaps the saved values with the current ones for the entries of one step.
+        void SwapStep(std::size_t step_index, bool reverse)
+        {
+            SwapEntries(step_index == 0 ? 0 : steps[step_index - 1].entries_end, steps[step_index].entries_end, reverse, [](const detail::Journal::Entry &){return true;});
+        }
+
+      public:
+        Journal() = default;
+
+        Journal(const Journal &) = delete;
+        Journal &operator=(const Journal &) = delete;
+
+        ~Journal()
+        {
+            DestroyEntries(0);
+        }
+
+        // Saves the value `object` had at the beginning of the current step. Call this before modifying it.
+        // Does nothing if `object` was already recorded in the current step, either by itself or as a part of a larger object.
+        // If some parts of `object` were already recorded in the current step and then modified, they are restored before saving it, so its saved value
+        //   is still the one from the beginning of the step. Since we can't tell which parts a non-trivially-copyable object owns through pointers
+        //   (e.g. vector elements), for those this restores every object recorded in this step and costs time proportional to their number,
+        //   so prefer recording the larger objects first.
+        // Trivially copyable types are saved as bytes, other types must be copy-constructible and swappable.
+        template <Meta::Deduce..., typename T>
+        void Record(T &object)
+        {
+            static_assert(!std::is_const_v<T>, "Recording a const object makes no sense.");
+
+            DiscardRedoSteps();
+
+            const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(&object);
+            const std::uintptr_t end = begin + sizeof(T);
+            if (AlreadyRecorded(begin, end))
+                return;
+
+            // The entries of this step that are inside of `object`. They become redundant once it's saved, so we remove them below.
+            auto is_nested = [&](const detail::Journal::Entry &e)
+            {
+                const std::uintptr_t e_begin = reinterpret_cast<std::uintptr_t>(e.target);
+                return e_begin >= begin && e_begin + e.size <= end;
+            };
+            // The entries of this step that `object` can contain, either directly or through pointers.
+            auto may_be_owned = [&](const detail::Journal::Entry &e)
+            {
+                return !std::is_trivially_copyable_v<T> || is_nested(e);
+            };
+
+            const std::size_t step_begin = CurrentStepBegin();
+            auto it = recorded_in_current_step.lower_bound(begin);
+            const bool has_nested = it != recorded_in_current_step.end() && it->first < end;
+            const bool restore_step = has_nested || (!std::is_trivially_copyable_v<T> && entries.size() > step_begin);
+
+            // Temporarily undo the changes that `object` might contain, so that we save its value from the beginning of the step.
+            if (restore_step)
+                SwapEntries(step_begin, entries.size(), true, may_be_owned);
+
+            detail::Journal::Entry e;
+            e.target = &object;
+            e.size = sizeof(T);
+            e.saved = arena.Allocate(sizeof(T), alignof(T));
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                std::memcpy(e.saved, &object, sizeof(T));
+                e.swap = detail::Journal::SwapBytes;
+            }
+            else
+            {
+                static_assert(std::is_copy_constructible_v<T> && std::is_swappable_v<T>, "Can only record the types that are trivially copyable, or copyable and swappable.");
+                try
+                {
+                    ::new(e.saved) T(object);
+                }
+                catch (...)
+                {
+                    if (restore_step)
+                        SwapEntries(step_begin, entries.size(), false, may_be_owned);
+                    throw;
+                }
+                e.swap = detail::Journal::SwapObjects<T>;
+                e.destroy = detail::Journal::DestroyObject<T>;
+            }
+
+            if (restore_step)
+                SwapEntries(step_begin, entries.size(), false, may_be_owned);
+
+            std::size_t old_num_entries = entries.size();
+            try
+            {
+                entries.push_back(e);
+                AddRecordedRange(begin, end);
+            }
+            catch (...)
+            {
+                entries.resize(old_num_entries);
+                if (e.destroy)
+                    e.destroy(e.saved);
+                throw;
+            }
+
+            // Remove the nested entries. The remaining entries that `object` owns through pointers are kept, since we can't tell them apart from
+            //   the unrelated ones. They are harmless: when undoing, `object` is restored before them, so they end up modifying the value saved for it,
+            //   and redoing reverts that.
+            if (has_nested)
+            {
+                std::size_t j = step_begin;
+                for (std::size_t i = step_begin; i < entries.size(); i++)
+                {
+                    if (i + 1 < entries.size() && is_nested(entries[i]))
+                    {
+                        if (entries[i].destroy)
+                            entries[i].destroy(entries[i].saved);
+                    }
+                    else
+                    {
+                        entries[j++] = entries[i];
+                    }
+                }
+                entries.resize(j);
+            }
+        }
+
+        // Records the `I`th non-static member of `object`, then returns it, like `Structs::GetMemberMutable()`.
+        template <int I, Meta::Deduce..., Structs::Type T> requires Structs::ValidMemberIndex<T, I>
+        [[nodiscard]] decltype(auto) GetMemberMutable(T &object)
+        {
+            decltype(auto) ret = Structs::GetMemberMutable<I>(object);
+            static_assert(std::is_lvalue_reference_v<decltype(ret)>, "This member isn't returned by reference, can't record it.");
+            Record(ret);
+            return ret;
+        }
+
+        // Finishes the current step. Does nothing if nothing was recorded since the last call.
+        void Commit()
+        {
+            recorded_in_current_step.clear();
+            if (entries.size() == CurrentStepBegin())
+                return;
+            steps.push_back({.entries_end = entries.size(), .arena_end = arena.GetMark()});
+        }
+
+        [[nodiscard]] bool CanUndo() const {return num_undone_steps < steps.size();}
+        [[nodiscard]] bool CanRedo() const {return num_undone_steps > 0;}
+
+        // Undoes the last committed step. Commits the current step first, if it's not empty.
+        // Returns false if there's nothing to undo.
+        bool Undo()
+        {
+            if (num_undone_steps == 0)
+                Commit();
+            if (!CanUndo())
+                return false;
+            SwapStep(steps.size() - 1 - num_undone_steps, true);
+            num_undone_steps++;
+            return true;
+        }
+
+        // Redoes the last undone step. Returns false if there's nothing to redo.
+        bool Redo()
+        {
+            if (!CanRedo())
+                return false;
+            num_undone_steps--;
+            SwapStep(steps.size() - 1 - num_undone_steps, false);
+            return true;
+        }
+
+        // Forgets all steps. Doesn't modify the recorded objects.
+        void Clear()
+        {
+            DestroyEntries(0);
+            steps.clear();
+            num_undone_steps = 0;
+            recorded_in_current_step.clear();
+            arena.Release({});
+        }
+
+        [[nodiscard]] std::size_t NumSteps() const {return steps.size();}
+
+        // The number of bytes allocated for the saved values. Doesn't include the bookkeeping.
+        [[nodiscard]] std::size_t MemoryUsage() const {return arena.MemoryUsage();}
+    };
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// All the macros of this library, for the translation units that `import em.refl;` (see `em/refl/module.cppm`) instead of including the headers.
+// Modules can't export macros, so they come from here. This only includes the headers that define macros, and those are small.
+// It's fine to include this without importing the module too, but then you need the regular headers for the rest of the API.
+
+#include "em/refl/hot_cold.h" // IWYU pragma: export
+#include "em/refl/macros/dirty.h" // IWYU pragma: export
+#include "em/refl/macros/static_virtual.h" // IWYU pragma: export
+#include "em/refl/macros/structs.h" // IWYU pragma: export
+#include "em/refl/minimize_padding.h" // IWYU pragma: export
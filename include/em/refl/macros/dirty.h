@@ -0,0 +1,22 @@
+#pragma once
+
+// The `EM_DIRTY_TRACKING` control statement for `EM_REFL()`. The rest of dirty tracking is in `em/refl/dirty.h`, see there for details.
+// This is split out so that `em/refl/macros.h` can provide the macro without pulling in the visitors.
+
+#include "em/meta/common.h" // IWYU pragma: keep, used in the macros.
+#include "em/refl/macros/structs.h"
+
+#include <bitset> // IWYU pragma: keep, used in the macros.
+
+// The control statement, place it at the beginning of `EM_REFL()`.
+#define EM_DIRTY_TRACKING EM_REFL_PREPROCESS_LOW(DETAIL_EM_DIRTY_TRACKING_BODY, DETAIL_EM_DIRTY_TRACKING_STEP, DETAIL_EM_DIRTY_TRACKING_FINAL, 0)
+
+// Leave all entries unchanged.
+#define DETAIL_EM_DIRTY_TRACKING_BODY(n, d, ...) (__VA_ARGS__)
+#define DETAIL_EM_DIRTY_TRACKING_STEP(n, d, ...) d
+// Then append the bitset after the members. The traits are emitted before the members, so we can already use `num_members` here.
+#define DETAIL_EM_DIRTY_TRACKING_FINAL(n, d) \
+    (verbatim, body, dirty_tracking,, \
+        ::std::bitset<_em_refl_Traits::_em_NonStatic::num_members> _em_dirty_bits; \
+        friend constexpr auto &_adl_em_refl_DirtyBits(int/*AdlDummy*/, ::em::Meta::same_ignoring_cvref<_em_Self> auto *_em_p) {return _em_p->_em_dirty_bits;} \
+    )
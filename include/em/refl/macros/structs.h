@@ -13,7 +13,6 @@
 #include "em/macros/meta/sequence_for.h"
 #include "em/macros/utils/forward.h"
 #include "em/meta/common.h" // IWYU pragma: keep, used in the macros.
-#include "em/meta/lists.h" // IWYU pragma: keep, used in the macros.
 #include "em/refl/common.h"
 #include "em/zstring_view.h"
 
@@ -21,6 +20,7 @@
 #include <cstddef> // IWYU pragma: keep, used in the macros.
 #include <string_view> // IWYU pragma: keep, used in the macros.
 #include <type_traits> // IWYU pragma: keep, used in the macros.
+#include <utility>
 
 
 namespace em::Refl::Structs
@@ -42,6 +42,75 @@ namespace em::Refl::Structs
             else
                 return value;
         }
+
+        // The `MemberInfo` of the `indirect_field` entries (see `EM_REFL_PREPROCESS_LOW()`), which aren't stored in the class itself.
+        template <typename Type, Attribute ...Attrs>
+        struct IndirectMemberInfo : MemberInfo<Type, Attrs...> {};
+
+        template <typename T>
+        constexpr bool is_indirect_member_info = false;
+        template <typename Type, Attribute ...Attrs>
+        constexpr bool is_indirect_member_info<IndirectMemberInfo<Type, Attrs...>> = true;
+
+        // `EM_REFL()` emits a struct per member into its traits class, derived from this. `Prev` is the previous such struct (or `NoMemberEntries`),
+        //   which is how we count the members without carrying the counters in the preprocessor state.
+        // The derived struct adds `_em_name`, `_em_Get()`, and `_em_Layout<Self>()` for the non-static fields.
+        template <typename Prev, bool IsStatic, typename Info>
+        struct MemberEntry
+        {
+            using _em_info = Info;
+            // The index among the static or non-static members, depending on `IsStatic`.
+            static constexpr int _em_index = IsStatic ? Prev::_em_num_static : Prev::_em_num_nonstatic;
+            static constexpr int _em_num_nonstatic = Prev::_em_num_nonstatic + !IsStatic;
+            static constexpr int _em_num_static = Prev::_em_num_static + IsStatic;
+        };
+        // The `Prev` of the first `MemberEntry`.
+        struct NoMemberEntries
+        {
+            static constexpr int _em_num_nonstatic = 0;
+            static constexpr int _em_num_static = 0;
+        };
+
+        // Given the `_em_refl_Traits` of a class, returns the `MemberEntry` of its `I`th static or non-static member.
+        // This is a single overload resolution instead of walking the members one by one.
+        template <typename Traits, bool IsStatic, int I>
+        using MemberEntryAt = decltype(Traits::_em_Member(Meta::ValueTag<IsStatic>{}, Meta::ValueTag<I>{}));
+
+        // The names of the first `N` static or non-static members of a class, given its `_em_refl_Traits`.
+        template <typename Traits, bool IsStatic, int N>
+        constexpr std::array<zstring_view, N> member_names = []<int ...I>(std::integer_sequence<int, I...>){
+            return std::array<zstring_view, N>{MemberEntryAt<Traits, IsStatic, I>::_em_name...};
+        }(std::make_integer_sequence<int, N>{});
+
+        // Checks that we can emit a `MemberLayoutEntry` for every one of the `N` non-static members of `Self`, given its `_em_refl_Traits`.
+        // We need the standard layout for `offsetof`, and it doesn't work on references. The indirect members have no offset at all.
+        template <typename Self, typename Traits, int N>
+        constexpr bool can_emit_member_layout = std::is_standard_layout_v<Self> && []<int ...I>(std::integer_sequence<int, I...>){
+            return ((!std::is_reference_v<typename MemberEntryAt<Traits, false, I>::_em_info::type> && !is_indirect_member_info<typename MemberEntryAt<Traits, false, I>::_em_info>) && ...);
+        }(std::make_integer_sequence<int, N>{});
+
+        template <typename Type, Attribute ...Attrs>
+        [[nodiscard]] constexpr MemberLayoutEntry MakeMemberLayoutEntry(std::size_t offset)
+        {
+            return {.offset = offset, .size = sizeof(Type), .alignment = alignof(Type), .type_id = type_id<std::remove_cv_t<Type>>};
+        }
+
+        template <typename Self, typename Traits, int N>
+        [[nodiscard]] constexpr std::array<MemberLayoutEntry, N> MakeMemberLayout()
+        {
+            return []<int ...I>(std::integer_sequence<int, I...>){
+                return std::array<MemberLayoutEntry, N>{MemberEntryAt<Traits, false, I>::template _em_Layout<Self>()...};
+            }(std::make_integer_sequence<int, N>{});
+        }
+
+        // The non-static member getters call this. If `self` isn't const and has dirty tracking enabled (see `EM_DIRTY_TRACKING` in `em/refl/dirty.h`),
+        //   marks the member as dirty.
+        template <int I, typename T>
+        constexpr void NotifyMutableAccess(T &&self)
+        {
+            if constexpr (!std::is_const_v<std::remove_reference_t<T>> && requires(std::remove_reference_t<T> *p){_adl_em_refl_DirtyBits(custom::AdlDummy{}, p);})
+                _adl_em_refl_DirtyBits(custom::AdlDummy{}, &self).set(std::size_t(I));
+        }
     }
 }
 
@@ -89,6 +158,9 @@ namespace em::Refl::Structs
 // If specified, the member names are not emitted.
 #define EM_UNNAMED_MEMBERS (,_em_unnamed_members)
 
+// There's also `EM_DIRTY_TRACKING` in `em/refl/dirty.h`, `EM_HOT_COLD_SPLIT` in `em/refl/hot_cold.h` and `EM_MINIMIZE_PADDING` in `em/refl/minimize_padding.h`,
+//   implemented in terms of `EM_REFL_PREPROCESS_LOW()` below.
+
 // Will preprocess the entire input sequence of `EM_REFL(...)` (including verbatim blocks and annotations, but excluding control statements),
 //   using those macros. Those are fed as parameters to `SF_FOR_EACH`.
 // On each iteration you'll receive one of the following entry kinds. You can emit it back as is, if you want to leave it unchanged.
@@ -100,11 +172,17 @@ namespace em::Refl::Structs
 //         A field declaration.
 //         `static_` is either `static` or empty.
 //         `decl_seq_verbatim_...` gets pasted before the declaration verbatim, it's for stuff like `inline` on static variables, etc.
+//     (indirect_field, (type_ [,attrs_...]), (expr_...), name_)
+//         A non-static member that's reflected, but not declared by `EM_REFL()`.
+//         `expr_...` is an expression that returns a reference to it, in terms of `_em_self`, which is a forwarding reference to the object
+//           (use `EM_FWD(_em_self)` to preserve the value category). It typically calls a static member function that you declare yourself.
+//         The `MemberLayoutEntry`s are not emitted for classes with such members. We never emit this entry kind ourselves.
 //     (verbatim, target_, tag_, metadata_, text_...)
 //         A verbatim text block.
 //         Here `target_` is one of:
 //           `body` - emitted in the class body, between the data memebrs.
-//           `traits` - emitted in the internal traits class that's generated for this class.
+//           `traits` - emitted in the internal traits class that's generated for this class. It's emitted before `_em_NonStatic` and `_em_Static`,
+//             so refer to those only in function bodies.
 //     (annotation, category_, error_if_unused_, data_...)
 //         An annotation, for use by external mixins. We ignore them, other than optionally erroring if they are unused.
 //         `category_` is a single word for dispatch, can be anything.
@@ -303,6 +381,7 @@ namespace em::Refl::Structs
 // Note that this is written in a particular way, to handle `name` and `name,` differently. The former gets zeroed via `{}`, while the latter is left uninitialized. The user can use the latter for types that are not default-constructible, which they plan to initialize in the member init list.
 #define DETAIL_EM_REFL_EMIT_MEMBERS_LOOP_BODY_KIND_field(static_, p_type_attrs_, p_decl_seq_verbatim_, .../*name, init...*/) EM_IDENTITY p_decl_seq_verbatim_ static_ ::em::Refl::Structs::detail::Macros::MemberType<EM_IDENTITY p_type_attrs_> EM_VA_FIRST(__VA_ARGS__) EM_IF_COMMA(__VA_ARGS__)(DETAIL_EM_REFL_EMIT_MEMBERS_LOOP_BODY_FIELD_INIT(__VA_ARGS__))({});
 #define DETAIL_EM_REFL_EMIT_MEMBERS_LOOP_BODY_FIELD_INIT(unused, ...) __VA_OPT__(= __VA_ARGS__)
+#define DETAIL_EM_REFL_EMIT_MEMBERS_LOOP_BODY_KIND_indirect_field(...)
 #define DETAIL_EM_REFL_EMIT_MEMBERS_LOOP_BODY_KIND_verbatim(target_, tag_, metadata_, .../*text*/) EM_CAT(DETAIL_EM_REFL_EMIT_MEMBERS_LOOP_BODY_VERBATIM_, target_)(__VA_ARGS__)
 #define DETAIL_EM_REFL_EMIT_MEMBERS_LOOP_BODY_VERBATIM_body(...) __VA_ARGS__
 #define DETAIL_EM_REFL_EMIT_MEMBERS_LOOP_BODY_VERBATIM_traits(...)
@@ -310,8 +389,10 @@ namespace em::Refl::Structs
 
 
 // Generates metadata for a class, the part of it that appears before the data members.
-#define DETAIL_EM_REFL_EMIT_METADATA_PRE(seq_, enable_member_names_) DETAIL_EM_REFL_EMIT_METADATA_PRE_2(seq_, enable_member_names_, SF_FOR_EACH(SF_NULL, DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_STEP, SF_STATE, DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_INITIAL_DATA, seq_))
-#define DETAIL_EM_REFL_EMIT_METADATA_PRE_2(seq_, enable_member_names_, traits_data_) \
+// This is a single pass over `seq_` with a constant-size state, see `DETAIL_EM_REFL_EMIT_METADATA_ENTRY_STEP` below. It emits a struct per member
+//   (see `::em::Refl::Structs::detail::Macros::MemberEntry`), and the getters then find those by index using overload resolution.
+// So both the preprocessor output and the getter instantiations are linear in the number of members.
+#define DETAIL_EM_REFL_EMIT_METADATA_PRE(seq_, enable_member_names_) \
     /* Typedef the enclosing class. This is intentionally not prefixed with `refl`, because it can appear in the user-written inheritance hooks, */\
     /* and I don't want to spell `refl` every time. The reflection is kinda privileged, so I don't see a problem with not prefixing it specifically */\
     /* in the reflection. */\
@@ -322,12 +403,17 @@ namespace em::Refl::Structs
     \
     struct _em_refl_Traits \
     { \
+        /* --- The stuff here is not customization points, don't add it to your own traits. */\
+        /* The member entries, and any custom traits the user specified via `EM_REFL_VERBATIM_LOW()`, in the same order as in `seq_`. */\
+        /* This also emits `_em_LastMember`, the last member entry. */\
+        /* The `_em_Member()` overloads are emitted per member, this dummy one ensures the name exists even if there are no members. */\
+        static void _em_Member(); \
+        SF_FOR_EACH(DETAIL_EM_REFL_EMIT_METADATA_ENTRY_BODY, DETAIL_EM_REFL_EMIT_METADATA_ENTRY_STEP, DETAIL_EM_REFL_EMIT_METADATA_ENTRY_FINAL, ::em::Refl::Structs::detail::Macros::NoMemberEntries, seq_) \
+        \
         /* Static and non-static data members. This emits two structs: `_em_NonStatic` and `_em_Static` for non-static and static members respectively. */\
         /* See `DETAIL_EM_REFL_EMIT_METADATA_STRUCTS()` for the contents of those structs. */\
-        DETAIL_EM_REFL_EMIT_METADATA_STRUCTS(enable_member_names_, EM_IDENTITY traits_data_) \
-        /* --- The stuff below is not customization points, don't add it to your own traits. */\
-        /* Emit any custom traits the user specified via `EM_REFL_VERBATIM_LOW()`. */\
-        EM_END(DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_A seq_) \
+        DETAIL_EM_REFL_EMIT_METADATA_STRUCTS(0/*not static*/, enable_member_names_, _em_NonStatic) \
+        DETAIL_EM_REFL_EMIT_METADATA_STRUCTS(1/*static*/, 1/*always enable names for static for now*/, _em_Static) \
     }; \
     /* This function is used to obtain traits for a class. */\
     /* We're currently using `same_ignoring_cvref<Self>` to reject derived types. */\
@@ -339,50 +425,69 @@ namespace em::Refl::Structs
     /* Poke the inheritance hook from any of the base classes. This is at the end just in case.*/\
     DETAIL_EM_REFL_TRIGGER_INHERITANCE_HOOK
 
-// This is a helper for the loop below, used to iterate over static and non-static data members.
-// `static_` is either `static` or empty.
-// `d` is the state for non-static and static members respectively: `((nonstatic_state...), (static_state...))`.
-// This macro modifies `d` as explained and returns the updated version.
-// `m` is a macro from `(is_static_, state..., ...)`. It receives either `0` or `1` as the first argument (1 if `static_`), then `[non]static_state...` (chosen based on `static_`),
-//   and then receives `...` as passed to this macro.
-// `m` must returns the updated `[non]static_state...`, which replaces the original in `d`, and then this macro returns the modified `d`.
-#define DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_DISPATCH_STATIC(static_, d, m, ...) DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_DISPATCH_STATIC_2(static_, EM_IDENTITY d, m, __VA_ARGS__)
-#define DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_DISPATCH_STATIC_2(static_, d_nonstatic_, d_static_, m, ...) EM_CAT(DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_DISPATCH_STATIC_SELECT_, static_)(d_nonstatic_, d_static_, m, __VA_ARGS__)
-#define DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_DISPATCH_STATIC_SELECT_(d_nonstatic_, d_static_, m, ...) ((EM_CALL(m, 0/*not static*/, EM_IDENTITY d_nonstatic_, __VA_ARGS__)), d_static_)
-#define DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_DISPATCH_STATIC_SELECT_static(d_nonstatic_, d_static_, m, ...) (d_nonstatic_, (EM_CALL(m, 1/*not static*/, EM_IDENTITY d_static_, __VA_ARGS__)))
-
-// This is the initial `data` variable for the loop below, which is used to fill traits for static and non-static data members.
-// Here we just repeat `DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_INITIAL_DATA_MAYBE_STATIC` twice, in parenthesis.
-#define DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_INITIAL_DATA (DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_INITIAL_DATA_MAYBE_STATIC/*non-static*/, DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_INITIAL_DATA_MAYBE_STATIC/*static*/)
-// This is the initial state that's used separately for static and non-static data members.
-#define DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_INITIAL_DATA_MAYBE_STATIC (0/*member count*/, (/*getmember*/), (/*attrs*/), (/*names*/))
-
-// The loop step for a loop that accumulates the necessary data to emit class member traits.
-// This same loop should have data set to `DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_INITIAL_DATA`, and final set to `SF_STATE`.
-#define DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_STEP(n, d, kind_, ...) EM_CAT(DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_STEP_SELECT_, kind_)(d, __VA_ARGS__)
-#define DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_STEP_SELECT_field(d, static_, ...) DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_DISPATCH_STATIC(static_, d, DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_STEP_FIELD, __VA_ARGS__)
-#define DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_STEP_SELECT_verbatim(d, ...) d
-#define DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_STEP_SELECT_annotation(d, ...) d
-#define DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_STEP_FIELD(is_static_, d_member_count_, d_getmember_, d_attrs_, d_names_, p_type_attrs_, p_decl_seq_verbatim_, name_, ...) \
-    d_member_count_+1, \
-    /* `MaybeMakeConst()` has to be here instead of in the API built on top of the traits, since it's up to the implementer of the traits to decide if they should propagate constness or not. */\
-    (EM_IDENTITY d_getmember_ if constexpr (_em_I == d_member_count_) return EM_IF_01(is_static_)(::em::Refl::Structs::detail::Macros::MaybeMakeConst<_em_IsConst, EM_IDENTITY p_type_attrs_>(name_))(EM_FWD(_em_self).name_); else), \
-    (EM_IDENTITY d_attrs_ , ::em::Refl::MemberInfo<EM_IDENTITY p_type_attrs_>), \
-    (EM_IDENTITY d_names_ #name_,) \
-
-// This is used to emit the combined static and non-static member traits.
+// The loop that emits the member entries into the traits class, along with the `traits` verbatim blocks.
+// The state `d` is the name of the previous member entry struct, initially `NoMemberEntries`. The entries use it to compute their indices.
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_BODY(n, d, kind_, ...) EM_CAT(DETAIL_EM_REFL_EMIT_METADATA_ENTRY_BODY_, kind_)(d, __VA_ARGS__)
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_BODY_field(d, static_, p_type_attrs_, p_decl_seq_verbatim_, name_, ...) \
+    DETAIL_EM_REFL_EMIT_METADATA_ENTRY_FIELD(d, EM_IF_CAT_ADDS_COMMA(DETAIL_EM_REFL_EMIT_METADATA_ENTRY_CHECK_STATIC_, static_)(1)(0), p_type_attrs_, name_)
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_BODY_indirect_field(d, p_type_attrs_, p_expr_, name_) \
+    DETAIL_EM_REFL_EMIT_METADATA_ENTRY_INDIRECT_FIELD(d, p_type_attrs_, p_expr_, name_)
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_BODY_verbatim(d, target_, tag_, metadata_, .../*text*/) EM_CAT(DETAIL_EM_REFL_EMIT_METADATA_ENTRY_BODY_VERBATIM_, target_)(__VA_ARGS__)
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_BODY_VERBATIM_body(...)
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_BODY_VERBATIM_traits(...) __VA_ARGS__
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_BODY_annotation(d, ...)
+
+// Every member entry replaces the state with its own name, everything else leaves it unchanged.
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_STEP(n, d, kind_, ...) EM_CAT(DETAIL_EM_REFL_EMIT_METADATA_ENTRY_STEP_, kind_)(d, __VA_ARGS__)
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_STEP_field(d, static_, p_type_attrs_, p_decl_seq_verbatim_, name_, ...) EM_CAT(_em_refl_M_, name_)
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_STEP_indirect_field(d, p_type_attrs_, p_expr_, name_) EM_CAT(_em_refl_M_, name_)
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_STEP_verbatim(d, ...) d
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_STEP_annotation(d, ...) d
+
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_FINAL(n, d) using _em_LastMember = d;
+
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_CHECK_STATIC_static ,
+
+// The member entry for a field. `is_static_` is 0 or 1.
+// All names in the entry are prefixed with `_em_`, to not shadow the names of the members themselves.
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_FIELD(prev_, is_static_, p_type_attrs_, name_) \
+    struct EM_CAT(_em_refl_M_, name_) : ::em::Refl::Structs::detail::Macros::MemberEntry<prev_, is_static_, ::em::Refl::MemberInfo<EM_IDENTITY p_type_attrs_>> \
+    { \
+        static constexpr ::em::zstring_view _em_name = #name_; \
+        EM_IF_01(is_static_)( \
+            /* `MaybeMakeConst()` has to be here instead of in the API built on top of the traits, since it's up to the implementer of the traits to decide if they should propagate constness or not. */\
+            template <bool _em_IsConst> \
+            static constexpr auto &&_em_Get() {return ::em::Refl::Structs::detail::Macros::MaybeMakeConst<_em_IsConst, EM_IDENTITY p_type_attrs_>(_em_Self::name_);} \
+        )( \
+            static constexpr auto &&_em_Get(auto &&_em_self) {return EM_FWD(_em_self).name_;} \
+            /* The layout is only emitted for non-static members. `_em_T` is the same as `_em_Self`, it's a template parameter to delay the checks. */\
+            template <typename _em_T> \
+            static constexpr ::em::Refl::MemberLayoutEntry _em_Layout() {return ::em::Refl::Structs::detail::Macros::MakeMemberLayoutEntry<EM_IDENTITY p_type_attrs_>(offsetof(_em_T, name_));} \
+        ) \
+    }; \
+    DETAIL_EM_REFL_EMIT_METADATA_ENTRY_INDEX(is_static_, EM_CAT(_em_refl_M_, name_))
+
+// Same, but for `indirect_field`. Those are always non-static.
+// We don't emit the layout for them, `IndirectMemberInfo` disables `GetMemberLayout()` for the whole class.
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_INDIRECT_FIELD(prev_, p_type_attrs_, p_expr_, name_) \
+    struct EM_CAT(_em_refl_M_, name_) : ::em::Refl::Structs::detail::Macros::MemberEntry<prev_, 0, ::em::Refl::Structs::detail::Macros::IndirectMemberInfo<EM_IDENTITY p_type_attrs_>> \
+    { \
+        static constexpr ::em::zstring_view _em_name = #name_; \
+        static constexpr auto &&_em_Get(auto &&_em_self) {return EM_IDENTITY p_expr_;} \
+    }; \
+    DETAIL_EM_REFL_EMIT_METADATA_ENTRY_INDEX(0, EM_CAT(_em_refl_M_, name_))
+
+// Makes the entry `entry_` findable by its index, see `MemberEntryAt`. This is never defined, only used in `decltype`.
+#define DETAIL_EM_REFL_EMIT_METADATA_ENTRY_INDEX(is_static_, entry_) \
+    static entry_ _em_Member(::em::Meta::ValueTag<bool(is_static_)>, ::em::Meta::ValueTag<entry_::_em_index>);
+
+// This is used to emit the static or non-static member traits.
 // `enable_member_names_` is 0 or 1 (only applies to non-static members for now, static ones could have a separate flag, but I didn't need it yet).
-// `...` is the data returned by the loop using `DETAIL_EM_REFL_EMIT_METADATA_MAKETRAITS_STEP`. It's basically `EM_IDENTITY (nonstatic..., static...)`
-#define DETAIL_EM_REFL_EMIT_METADATA_STRUCTS(enable_member_names_, ...) DETAIL_EM_REFL_EMIT_METADATA_STRUCTS_2(enable_member_names_, __VA_ARGS__)
-#define DETAIL_EM_REFL_EMIT_METADATA_STRUCTS_2(enable_member_names_, nonstatic_, static_) \
-    DETAIL_EM_REFL_EMIT_METADATA_STRUCTS_3(0/*not static*/, enable_member_names_, _em_NonStatic, EM_IDENTITY nonstatic_) \
-    DETAIL_EM_REFL_EMIT_METADATA_STRUCTS_3(1/*static*/, 1/*always enable names for static for now*/, _em_Static, EM_IDENTITY static_)
-#define DETAIL_EM_REFL_EMIT_METADATA_STRUCTS_3(is_static_, enable_member_names_, struct_name_, ...) DETAIL_EM_REFL_EMIT_METADATA_STRUCTS_4(is_static_, enable_member_names_, struct_name_, __VA_ARGS__)
-#define DETAIL_EM_REFL_EMIT_METADATA_STRUCTS_4(is_static_, enable_member_names_, struct_name_, d_member_count_, d_getmember_, d_attrs_, d_names_) \
+#define DETAIL_EM_REFL_EMIT_METADATA_STRUCTS(is_static_, enable_member_names_, struct_name_) \
     struct struct_name_ \
     { \
         /* Member count. */\
-        static constexpr int num_members = d_member_count_; \
+        static constexpr int num_members = EM_IF_01(is_static_)(_em_LastMember::_em_num_static)(_em_LastMember::_em_num_nonstatic); \
         /* A getter for the members. */\
         /* Here we return a reference, but custom classes can also return by value here. */\
         /* The function parameter is only there in non-static traits. */\
@@ -390,39 +495,41 @@ namespace em::Refl::Structs
         template <int _em_I EM_IF_01(is_static_)(, bool _em_IsConst)()> \
         static constexpr auto &&GetMember( EM_IF_01(is_static_)()(auto &&_em_self) ) \
         { \
-            EM_IDENTITY d_getmember_ \
-            static_assert(::em::Meta::always_false<EM_IF_01(is_static_)()(decltype(_em_self),) ::em::Meta::ValueTag<_em_I>>, "Member index is out of range."); \
+            static_assert(_em_I >= 0 && _em_I < num_members, "Member index is out of range."); \
+            EM_IF_01(is_static_)( \
+                return ::em::Refl::Structs::detail::Macros::MemberEntryAt<_em_refl_Traits, true, _em_I>::template _em_Get<_em_IsConst>(); \
+            )( \
+                ::em::Refl::Structs::detail::Macros::NotifyMutableAccess<_em_I>(_em_self); \
+                return ::em::Refl::Structs::detail::Macros::MemberEntryAt<_em_refl_Traits, false, _em_I>::_em_Get(EM_FWD(_em_self)); \
+            ) \
         } \
         /* [optional] Return something with `::type` to indicate a member type (omit or `void` to guess),
         // and with `::attrs` with a type list of attributes (the list can be any variadic template, omit if no attributes). */\
         template <int _em_I> \
         static constexpr auto GetMemberInfo() \
         { \
-            return ::em::Meta::list_type_at<::em::Meta::TypeList<EM_REMOVE_LEADING_COMMA(EM_IDENTITY d_attrs_)>, _em_I>{}; \
+            return typename ::em::Refl::Structs::detail::Macros::MemberEntryAt<_em_refl_Traits, bool(is_static_), _em_I>::_em_info{}; \
         } \
         /* [optional] Return the member name. Omit the function to indicate the lack of names. */\
         /* Currently there's no way to disable this for static members with `EM_REFL()`. */\
         EM_IF_01(enable_member_names_)( \
             static constexpr ::em::zstring_view GetMemberName(int _em_i) \
             { \
-                static constexpr ::std::array<::em::zstring_view, num_members> _em_array = {EM_IDENTITY d_names_}; \
-                return _em_array[::std::size_t(_em_i)]; \
+                return ::em::Refl::Structs::detail::Macros::member_names<_em_refl_Traits, bool(is_static_), num_members>[::std::size_t(_em_i)]; \
             } \
         )() \
+        /* [optional] Return the offsets, sizes, etc of the members. Only for non-static members. Omit or disable the function if not applicable. */\
+        /* This is a template to delay the checks until the enclosing class is complete. */\
+        EM_IF_01(is_static_)()( \
+            template <typename _em_T = _em_Self> \
+            requires ::em::Refl::Structs::detail::Macros::can_emit_member_layout<_em_T, _em_refl_Traits, num_members> \
+            static constexpr ::std::array<::em::Refl::MemberLayoutEntry, num_members> GetMemberLayout() \
+            { \
+                return ::em::Refl::Structs::detail::Macros::MakeMemberLayout<_em_T, _em_refl_Traits, num_members>(); \
+            } \
+        ) \
     }; \
 
-// A loop emit custom user-provided code into the traits class.
-#define DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_A(...) DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_BODY(__VA_ARGS__) DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_B
-#define DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_B(...) DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_BODY(__VA_ARGS__) DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_A
-#define DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_A_END
-#define DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_B_END
-#define DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_BODY(kind_, ...) EM_CAT(DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_BODY_KIND_, kind_)(__VA_ARGS__)
-#define DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_BODY_KIND_field(...)
-#define DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_BODY_KIND_verbatim(target_, tag_, metadata_, .../*text*/) EM_CAT(DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_BODY_VERBATIM_, target_)(__VA_ARGS__)
-#define DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_BODY_VERBATIM_body(...)
-#define DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_BODY_VERBATIM_traits(...) __VA_ARGS__
-#define DETAIL_EM_REFL_EMIT_METADATA_TRAITS_LOOP_BODY_KIND_annotation(...)
-
 // Trigger the inheritance hook in the base classes, and in this class itself.
 #define DETAIL_EM_REFL_TRIGGER_INHERITANCE_HOOK \
     static void _em_TriggerInheritanceHook() \
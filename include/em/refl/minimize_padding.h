@@ -0,0 +1,173 @@
+#pragma once
+
+#include "em/macros/meta/common.h"
+#include "em/macros/meta/if_else.h"
+#include "em/macros/utils/forward.h"
+#include "em/refl/macros/structs.h"
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Reorders the members of `EM_REFL()` structs to minimize padding.
+// Put `EM_MINIMIZE_PADDING` before the members in `EM_REFL()`, and the non-static members are stored sorted by alignment (largest first, otherwise
+//   in the declaration order), which leaves no padding between them.
+// The reflection still sees them in the declaration order, with the same indices, names and types.
+//
+// The preprocessor doesn't know the alignments, so the members are not declared individually, but stored in a single member with a computed layout.
+// Because of that:
+// * They can't be accessed by name, use the reflection getters.
+// * The initializers can't refer to other members.
+// * `Structs::MemberLayout()` isn't available for such structs, and they aren't `BulkCopyable`.
+// Static members are left alone.
+
+// The control statement, place it at the beginning of `EM_REFL()`.
+#define EM_MINIMIZE_PADDING EM_REFL_PREPROCESS_LOW(DETAIL_EM_MINIMIZE_PADDING_BODY, DETAIL_EM_MINIMIZE_PADDING_STEP, DETAIL_EM_MINIMIZE_PADDING_FINAL, ::em::Refl::detail::MinimizePadding::SlotList<>)
+
+namespace em::Refl::detail::MinimizePadding
+{
+    // How to initialize a `Slot`: `ValueInit` for `{}`, `DefaultInit` for no initializer, otherwise a lambda returning the initial value.
+    struct ValueInit {};
+    struct DefaultInit {};
+
+    template <typename T, typename Init>
+    struct Slot
+    {
+        static_assert(!std::is_reference_v<T>, "`EM_MINIMIZE_PADDING` doesn't support reference members.");
+
+        T value;
+
+        constexpr Slot() requires std::is_same_v<Init, ValueInit> : value{} {}
+        constexpr Slot() requires std::is_same_v<Init, DefaultInit> {}
+        constexpr Slot() requires(!std::is_same_v<Init, ValueInit> && !std::is_same_v<Init, DefaultInit>) : value(Init{}()) {}
+    };
+
+    // One slot of `Seq`, `I` is its physical position.
+    template <std::size_t I, typename S>
+    struct SeqElem
+    {
+        S slot;
+    };
+
+    template <typename Indices, typename ...S>
+    struct SeqLow {};
+    template <std::size_t ...I, typename ...S>
+    struct SeqLow<std::index_sequence<I...>, S...> : SeqElem<I, S>... {};
+
+    // Stores the slots in this order. The bases are laid out in order, so this doesn't add padding as long as the slots are sorted by decreasing alignment.
+    // This is flat rather than recursive, so that accessing a slot is a single cast to its base, regardless of its position.
+    template <typename ...S>
+    using Seq = SeqLow<std::make_index_sequence<sizeof...(S)>, S...>;
+
+    // For every physical position, the index of the slot there. The slots are stably sorted by decreasing alignment.
+    template <typename ...S>
+    constexpr std::array<std::size_t, sizeof...(S)> physical_order = []{
+        constexpr std::size_t alignments[] = {alignof(S)..., 0};
+        std::array<std::size_t, sizeof...(S)> ret{};
+        for (std::size_t i = 0; i < sizeof...(S); i++)
+        {
+            // Insertion sort, since it's stable.
+            std::size_t j = i;
+            for (; j > 0 && alignments[ret[j - 1]] < alignments[i]; j--)
+                ret[j] = ret[j - 1];
+            ret[j] = i;
+        }
+        return ret;
+    }();
+
+    // The inverse of `physical_order`.
+    template <typename ...S>
+    constexpr std::array<std::size_t, sizeof...(S)> physical_position = []{
+        std::array<std::size_t, sizeof...(S)> ret{};
+        for (std::size_t i = 0; i < sizeof...(S); i++)
+            ret[physical_order<S...>[i]] = i;
+        return ret;
+    }();
+
+    template <typename List, typename Seq>
+    struct SortedSeq {};
+    template <typename ...S, std::size_t ...I>
+    struct SortedSeq<Meta::TypeList<S...>, std::index_sequence<I...>>
+    {
+        using type = Seq<Meta::list_type_at<Meta::TypeList<S...>, physical_order<S...>[I]>...>;
+    };
+
+    // Stores the slots `S...` (in the declaration order) sorted by alignment.
+    template <typename ...S>
+    struct Storage
+    {
+        typename SortedSeq<Meta::TypeList<S...>, std::make_index_sequence<sizeof...(S)>>::type seq;
+
+        // Returns the value of the `I`th slot in the declaration order, preserving the constness and value category of `self`.
+        template <std::size_t I, Meta::Deduce..., typename T>
+        [[nodiscard]] static constexpr auto &&Get(T &&self)
+        {
+            using Elem = SeqElem<physical_position<S...>[I], Meta::list_type_at<Meta::TypeList<S...>, I>>;
+            return static_cast<Meta::copy_cvref<T &&, Elem>>(self.seq).slot.value;
+        }
+    };
+    template <>
+    struct Storage<> {};
+
+    // The slots declared so far. `EM_MINIMIZE_PADDING` declares one of those per non-static field, each one extending the previous one,
+    //   so the preprocessor doesn't have to carry the whole list around.
+    template <typename ...S>
+    struct SlotList
+    {
+        // The index of the next slot.
+        static constexpr std::size_t size = sizeof...(S);
+
+        template <typename T>
+        using append = SlotList<S..., T>;
+
+        using storage = MinimizePadding::Storage<S...>;
+    };
+}
+
+// --- Internals:
+
+// The state is the name of the last `SlotList` typedef, initially `SlotList<>`.
+// Every non-static field declares `_em_MinimizePadding_Slots_<name>` (by emitting a verbatim block), which adds its slot to the previous list.
+
+#define DETAIL_EM_MINIMIZE_PADDING_BODY(n, d, kind_, ...) EM_CAT(DETAIL_EM_MINIMIZE_PADDING_BODY_, kind_)(d, __VA_ARGS__)
+#define DETAIL_EM_MINIMIZE_PADDING_BODY_field(d, static_, p_type_attrs_, p_decl_seq_verbatim_, .../*name_, init_...*/) \
+    EM_IF_CAT_ADDS_COMMA(DETAIL_EM_MINIMIZE_PADDING_CHECK_STATIC_, static_) \
+        ((field, static_, p_type_attrs_, p_decl_seq_verbatim_, __VA_ARGS__)) \
+        ( \
+            (verbatim, body, minimize_padding,, \
+                using DETAIL_EM_MINIMIZE_PADDING_SLOTS(__VA_ARGS__) = typename d::template append< \
+                    ::em::Refl::detail::MinimizePadding::Slot<::em::Refl::Structs::detail::Macros::MemberType<EM_IDENTITY p_type_attrs_>, DETAIL_EM_MINIMIZE_PADDING_INIT(p_type_attrs_, __VA_ARGS__)> \
+                >; \
+            ) \
+            (indirect_field, p_type_attrs_, (_em_Self::_em_MinimizePadding_Storage::template Get<_em_Self::DETAIL_EM_MINIMIZE_PADDING_SLOTS(__VA_ARGS__)::size - 1>(EM_FWD(_em_self)._em_minimize_padding_storage)), EM_VA_FIRST(__VA_ARGS__)) \
+        )
+#define DETAIL_EM_MINIMIZE_PADDING_BODY_indirect_field(d, ...) (indirect_field, __VA_ARGS__)
+#define DETAIL_EM_MINIMIZE_PADDING_BODY_verbatim(d, ...) (verbatim, __VA_ARGS__)
+#define DETAIL_EM_MINIMIZE_PADDING_BODY_annotation(d, ...) (annotation, __VA_ARGS__)
+
+#define DETAIL_EM_MINIMIZE_PADDING_STEP(n, d, kind_, ...) EM_CAT(DETAIL_EM_MINIMIZE_PADDING_STEP_, kind_)(d, __VA_ARGS__)
+#define DETAIL_EM_MINIMIZE_PADDING_STEP_field(d, static_, p_type_attrs_, p_decl_seq_verbatim_, .../*name_, init_...*/) \
+    EM_IF_CAT_ADDS_COMMA(DETAIL_EM_MINIMIZE_PADDING_CHECK_STATIC_, static_)(d)(DETAIL_EM_MINIMIZE_PADDING_SLOTS(__VA_ARGS__))
+#define DETAIL_EM_MINIMIZE_PADDING_STEP_indirect_field(d, ...) d
+#define DETAIL_EM_MINIMIZE_PADDING_STEP_verbatim(d, ...) d
+#define DETAIL_EM_MINIMIZE_PADDING_STEP_annotation(d, ...) d
+
+// Given `name_, init_...`, returns the name of the `SlotList` typedef for this field.
+#define DETAIL_EM_MINIMIZE_PADDING_SLOTS(...) EM_CAT(_em_MinimizePadding_Slots_, EM_VA_FIRST(__VA_ARGS__))
+
+#define DETAIL_EM_MINIMIZE_PADDING_CHECK_STATIC_static ,
+
+// Returns the `Init` parameter of `Slot`. This mirrors how `DETAIL_EM_REFL_EMIT_MEMBERS()` handles `name_` (`{}`), `name_,` (no initializer), and `name_, init_...`.
+#define DETAIL_EM_MINIMIZE_PADDING_INIT(p_type_attrs_, .../*name_, init_...*/) \
+    EM_IF_COMMA(__VA_ARGS__)(DETAIL_EM_MINIMIZE_PADDING_INIT_EXPLICIT(p_type_attrs_, __VA_ARGS__))(::em::Refl::detail::MinimizePadding::ValueInit)
+#define DETAIL_EM_MINIMIZE_PADDING_INIT_EXPLICIT(p_type_attrs_, name_, ...) \
+    EM_IF_COMMA(__VA_OPT__(,)) \
+        (decltype([]() -> ::em::Refl::Structs::detail::Macros::MemberType<EM_IDENTITY p_type_attrs_> {return __VA_ARGS__;})) \
+        (::em::Refl::detail::MinimizePadding::DefaultInit)
+
+#define DETAIL_EM_MINIMIZE_PADDING_FINAL(n, d) \
+    (verbatim, body, minimize_padding,, \
+        using _em_MinimizePadding_Storage = typename d::storage; \
+        _em_MinimizePadding_Storage _em_minimize_padding_storage; \
+    )
@@ -0,0 +1,116 @@
+// The C++20 module interface of this library. Build a BMI from this file once, then `import em.refl;` instead of including the headers.
+// It exports everything from the headers under `em/refl/`.
+// The dependencies (`em/meta`, `em/macros`, `em/zstring_view.h`, fmt, and the standard library) are not exported, include the ones you need yourself.
+// Modules can't export macros, so include `em/refl/macros.h` for `EM_REFL()` and others.
+//
+// EXPERIMENTAL: This hasn't been shown to build and import successfully with any compiler yet.
+//   GCC 12 hits an internal compiler error when writing the BMI (caused by any `fmt::format()` call in the module purview), and when importing
+//   a BMI built without the headers that use fmt, it loses default template arguments and reports the declarations from `em/refl/macros.h` as ambiguous.
+//
+// The declarations below are attached to the global module with `extern "C++"`, so that a compiler can merge them with the same declarations
+//   seen through the headers. `em/refl/macros.h` includes some of those headers, so importers depend on that merging. Mixing this module with
+//   any other headers of this library in the same translation unit is not supported.
+//
+// The intended usage, e.g. with Clang (untested, see above):
+//     clang++ -std=c++23 -Iinclude <other flags> --precompile include/em/refl/module.cppm -o em.refl.pcm
+//     clang++ -std=c++23 -Iinclude <other flags> -fmodule-file=em.refl=em.refl.pcm -c foo.cpp
+// The flags must match between the two, as usual. See `test/module.import.cpp` for an example of a user.
+
+module;
+
+// Everything the headers below include from outside of this library, so that it ends up in the global module fragment, and isn't exported.
+// When adding a new include to any of the headers, add it here too.
+
+#include "em/macros/meta/comma.h"
+#include "em/macros/meta/common.h"
+#include "em/macros/meta/detectable_base.h"
+#include "em/macros/meta/enclosing_class.h"
+#include "em/macros/meta/if_else.h"
+#include "em/macros/meta/optional_parens.h"
+#include "em/macros/meta/ranges.h"
+#include "em/macros/meta/sequence_for.h"
+#include "em/macros/platform/compiler.h"
+#include "em/macros/portable/warnings.h"
+#include "em/macros/utils/flag_enum.h"
+#include "em/macros/utils/forward.h"
+#include "em/meta/common.h"
+#include "em/meta/const_for.h"
+#include "em/meta/detect_bases.h"
+#include "em/meta/lists.h"
+#include "em/meta/stateful/flag.h"
+#include "em/meta/type_name.h"
+#include "em/meta/type_predicates.h"
+#include "em/zstring_view.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <bitset>
+#include <cassert>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+export module em.refl;
+
+export extern "C++"
+{
+    #include "em/refl/access/adjust.h"
+    #include "em/refl/access/bases.h"
+    #include "em/refl/access/indirect.h"
+    #include "em/refl/access/ranges.h"
+    #include "em/refl/access/structs.h"
+    #include "em/refl/access/variants.h"
+    #include "em/refl/bulk_copyable.h"
+    #include "em/refl/classify.h"
+    #include "em/refl/common.h"
+    #include "em/refl/compare.h"
+    #include "em/refl/diff.h"
+    #include "em/refl/dirty.h"
+    #include "em/refl/fingerprint.h"
+    #include "em/refl/hash.h"
+    #include "em/refl/hot_cold.h"
+    #include "em/refl/journal.h"
+    #include "em/refl/macros/dirty.h"
+    #include "em/refl/macros/static_virtual.h"
+    #include "em/refl/macros/structs.h"
+    #include "em/refl/minimize_padding.h"
+    #include "em/refl/recursively_visit_elems.h"
+    #include "em/refl/recursively_visit_elems_parallel.h"
+    #include "em/refl/recursively_visit_elems_static.h"
+    #include "em/refl/recursively_visit_types.h"
+    #include "em/refl/serialize/binary.h"
+    #include "em/refl/serialize/binary_stream.h"
+    #include "em/refl/serialize/flat.h"
+    #include "em/refl/serialize/versioned.h"
+    #include "em/refl/soa_vector.h"
+    #include "em/refl/static_virtual.h"
+    #include "em/refl/visit_members.h"
+    #include "em/refl/visit_members_static.h"
+    #include "em/refl/visit_types.h"
+    #include "em/refl/visit_types_static.h"
+}
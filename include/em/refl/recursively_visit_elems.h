@@ -54,12 +54,11 @@ namespace em::Refl
             },
             [&]<typename Pred2 = Pred> -> decltype(auto)
             {
-                // Here `TypeRecursivelyContainsPred` doesn't respect `ignore_root` (returns a false positive),
-                //   but since the resulting iteration only traverses bases, it should be free.
-                // It's easier to do this than to patch `TypeRecursivelyContainsPred`.
+                // Only descend if some subobject matches. This is memoized per type node (and shares `ChildTypes<T, Mode>` with the other recursive queries),
+                //   so checking this on every level is cheap.
                 //
                 // Note that this condition is not purely an optimization. Visiting unnecessary subtrees can fail to compile if we're looping backwards, and they are not backwards-iterable.
-                if constexpr (TypeRecursivelyContainsPred<T, Pred2>)
+                if constexpr (TypeRecursivelyContainsPred<T, Pred2, IterationFlags::ignore_root, Meta::true_predicate, Mode>)
                 {
                     return (VisitMembers<LoopBackend, Flags, Mode>)(EM_FWD(input), [&]<VisitDesc Desc>(auto &&member) -> decltype(auto)
                     {
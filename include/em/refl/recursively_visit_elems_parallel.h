@@ -0,0 +1,227 @@
+#pragma once
+
+#include "em/macros/utils/forward.h"
+#include "em/meta/common.h"
+#include "em/refl/classify.h"
+#include "em/refl/common.h"
+#include "em/refl/recursively_visit_types.h"
+#include "em/refl/visit_members.h"
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ranges>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// A parallel version of `RecursivelyVisitElemsMatchingPred()`, that passes the elements to the callback as const.
+// Large random-access ranges are split into chunks that are processed on multiple threads, and the per-chunk results are combined with a reduction.
+//
+// There's no thread pool: every range that gets parallelized starts `num_threads - 1` new threads and joins them before moving on,
+//   which costs some tens of microseconds per range. So this only pays off when each range has enough work, see `ParallelVisitOptions::min_chunk_size`.
+
+namespace em::Refl
+{
+    struct ParallelVisitOptions
+    {
+        // How many threads to use at most. Zero means `std::thread::hardware_concurrency()`.
+        unsigned int num_threads = 0;
+
+        // Ranges with fewer elements than this are visited sequentially. Also no chunk will be smaller than this.
+        // Since the threads are started anew for every parallelized range, pick this so that a chunk takes much longer than starting a thread.
+        std::size_t min_chunk_size = 1024;
+
+        // How many chunks to create per thread. More chunks balance the load better when the elements take different time to process.
+        std::size_t chunks_per_thread = 4;
+    };
+
+    namespace detail::ParallelVisit
+    {
+        template <typename R, typename F, typename Reduce>
+        struct Context
+        {
+            const R &init;
+            F &func;
+            Reduce &reduce;
+            const ParallelVisitOptions &options;
+            unsigned int num_threads = 1;
+            // This is false when we're already inside of a parallel range, to avoid nested parallelism.
+            bool allow_parallel = true;
+        };
+
+        // The alignment of the per-chunk results, so that the threads writing them don't share cache lines.
+        // GCC warns that this value depends on the `-mtune` flags, but it's only used for a local array, not in any interface.
+        #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Winterference-size"
+        #endif
+        #ifdef __cpp_lib_hardware_interference_size
+        inline constexpr std::size_t result_alignment = std::hardware_destructive_interference_size;
+        #else
+        inline constexpr std::size_t result_alignment = 64;
+        #endif
+        #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC diagnostic pop
+        #endif
+
+        // A result of one chunk. Not using `std::vector<R>`, since it packs `bool`s into bits, and it would also put neighboring results into the same cache line.
+        template <typename R>
+        struct alignas(result_alignment) ResultSlot
+        {
+            R value;
+        };
+
+        template <typename T>
+        concept ChunkableRange = std::ranges::random_access_range<std::remove_cvref_t<T>> && std::ranges::sized_range<std::remove_cvref_t<T>>;
+
+        template <Meta::TypePredicate Pred, IterationFlags Flags, VisitMode Mode, Meta::Deduce..., typename R, typename F, typename Reduce, typename T>
+        void VisitLow(const Context<R, F, Reduce> &ctx, R &acc, T &&input);
+
+        // Visits the elements `[begin, end)` of a range sequentially.
+        template <Meta::TypePredicate Pred, IterationFlags Flags, Meta::Deduce..., typename R, typename F, typename Reduce, typename T>
+        void VisitRangeSlice(const Context<R, F, Reduce> &ctx, R &acc, T &&range, std::size_t begin, std::size_t end)
+        {
+            auto it = std::ranges::begin(range) + std::ranges::range_difference_t<std::remove_cvref_t<T>>(begin);
+            for (std::size_t i = begin; i < end; i++, ++it)
+                (VisitLow<Pred, Flags, VisitMode::normal>)(ctx, acc, Ranges::ForwardElement<T>(*it));
+        }
+
+        // Visits a range in parallel, if it's large enough.
+        template <Meta::TypePredicate Pred, IterationFlags Flags, Meta::Deduce..., typename R, typename F, typename Reduce, typename T>
+        void VisitRange(const Context<R, F, Reduce> &ctx, R &acc, T &&range)
+        {
+            const std::size_t size = std::size_t(std::ranges::size(range));
+            const std::size_t min_chunk_size = std::max(ctx.options.min_chunk_size, std::size_t(1));
+
+            if (!ctx.allow_parallel || ctx.num_threads < 2 || size < min_chunk_size * 2)
+            {
+                (VisitRangeSlice<Pred, Flags>)(ctx, acc, range, 0, size);
+                return;
+            }
+
+            const std::size_t num_chunks = std::clamp(size / min_chunk_size, std::size_t(1), ctx.num_threads * std::max(ctx.options.chunks_per_thread, std::size_t(1)));
+            const std::size_t num_threads = std::min(std::size_t(ctx.num_threads), num_chunks);
+
+            Context<R, F, Reduce> nested_ctx = ctx;
+            nested_ctx.allow_parallel = false;
+
+            // Each chunk has its own result, and they are combined in order at the end, so `reduce` doesn't have to be commutative.
+            auto chunk_results = std::make_unique<ResultSlot<R>[]>(num_chunks);
+            for (std::size_t i = 0; i < num_chunks; i++)
+                chunk_results[i].value = ctx.init;
+            std::atomic<std::size_t> next_chunk = 0;
+            std::exception_ptr exception;
+            std::mutex exception_mutex;
+
+            auto worker = [&]
+            {
+                // The threads claim the chunks dynamically, so a thread that finishes early takes over the remaining work.
+                for (std::size_t chunk; (chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) < num_chunks;)
+                {
+                    try
+                    {
+                        (VisitRangeSlice<Pred, Flags>)(nested_ctx, chunk_results[chunk].value, range, size * chunk / num_chunks, size * (chunk + 1) / num_chunks);
+                    }
+                    catch (...)
+                    {
+                        std::scoped_lock lock(exception_mutex);
+                        if (!exception)
+                            exception = std::current_exception();
+                        next_chunk.store(num_chunks, std::memory_order_relaxed); // Stop the other threads.
+                    }
+                }
+            };
+
+            {
+                std::vector<std::jthread> threads;
+                threads.reserve(num_threads - 1);
+                for (std::size_t i = 1; i < num_threads; i++)
+                    threads.emplace_back(worker);
+                worker(); // The current thread helps too.
+            }
+
+            if (exception)
+                std::rethrow_exception(exception);
+
+            for (std::size_t i = 0; i < num_chunks; i++)
+                acc = ctx.reduce(std::move(acc), std::move(chunk_results[i].value));
+        }
+
+        // This mirrors `RecursivelyVisitElemsMatchingPred()`, see that for the explanation of the flags.
+        template <Meta::TypePredicate Pred, IterationFlags Flags, VisitMode Mode, Meta::Deduce..., typename R, typename F, typename Reduce, typename T>
+        void VisitLow(const Context<R, F, Reduce> &ctx, R &acc, T &&input)
+        {
+            static constexpr bool is_new_instance = !(Mode == VisitMode::base_subobject && bool(Flags & IterationFlags::predicate_finds_bases));
+
+            static constexpr IterationFlags next_flags = is_new_instance ? Flags & ~IterationFlags::ignore_root : Flags;
+
+            static constexpr IterationFlags next_flags_base = []{
+                if constexpr (bool(Flags & IterationFlags::predicate_finds_bases) && !bool(Flags & IterationFlags::ignore_root))
+                    return next_flags | IterationFlags::ignore_root * Pred::template type<T &&>::value;
+                else
+                    return next_flags;
+            }();
+
+            if constexpr (!bool(Flags & IterationFlags::ignore_root) && Pred::template type<T &&>::value)
+            {
+                // Force constness, even if it wasn't propagated (e.g. by pointers).
+                acc = ctx.reduce(std::move(acc), ctx.func(std::as_const(input)));
+            }
+
+            if constexpr (TypeRecursivelyContainsPred<T, Pred>)
+            {
+                if constexpr (classify_opt<T> == Category::range && ChunkableRange<T>)
+                {
+                    (VisitRange<Pred, next_flags>)(ctx, acc, EM_FWD(input));
+                }
+                else
+                {
+                    (VisitMembers<Meta::LoopSimple, Flags, Mode>)(EM_FWD(input), [&]<VisitDesc Desc>(auto &&member)
+                    {
+                        static constexpr IterationFlags cur_flags = std::derived_from<VisitingAnyBase, Desc> ? next_flags_base : next_flags;
+
+                        (VisitLow<Pred, cur_flags, Desc::mode>)(ctx, acc, EM_FWD(member));
+                    });
+                }
+            }
+        }
+    }
+
+    // Like `RecursivelyVisitElemsMatchingPred()`, but read-only and parallel, and combines the results of `func` using `reduce`.
+    // `func` is `(const auto &elem) -> R`. It's called from multiple threads at the same time, so it must be thread-safe.
+    //   It always receives the elements by const reference, even if the constness wasn't propagated (e.g. through pointers).
+    //   That only protects against accidental writes through the argument. Anything else `func` touches (captures, globals, `mutable` members)
+    //   is shared between the threads without synchronization, and that's up to you.
+    // `reduce` is `(R, R) -> R`. It must be associative, but not necessarily commutative. `init` must be its identity element.
+    // `R` must be default-constructible and copy-assignable.
+    // Returns `init` reduced with all results of `func`, in the same order as the sequential pre-order traversal would produce.
+    // Only the ranges that are random-access and sized are parallelized, and only the outermost such range on each path.
+    template <Meta::TypePredicate Pred, IterationFlags Flags = {}, Meta::Deduce..., typename T, typename R, typename F, typename Reduce>
+    [[nodiscard]] R RecursivelyVisitElemsMatchingPredParallel(const T &input, R init, F &&func, Reduce &&reduce, const ParallelVisitOptions &options = {})
+    {
+        detail::ParallelVisit::Context<R, std::remove_reference_t<F>, std::remove_reference_t<Reduce>> ctx{
+            .init = init,
+            .func = func,
+            .reduce = reduce,
+            .options = options,
+            .num_threads = options.num_threads ? options.num_threads : std::max(std::thread::hardware_concurrency(), 1u),
+        };
+
+        R ret = init;
+        (detail::ParallelVisit::VisitLow<Pred, Flags, VisitMode::normal>)(ctx, ret, input);
+        return ret;
+    }
+
+    // Same, but visits the instances of `Elem`, like `RecursivelyVisitElemsOfTypeCvref()`.
+    template <typename Elem, IterationFlags Flags = {}, Meta::Deduce..., typename T, typename R, typename F, typename Reduce>
+    [[nodiscard]] R RecursivelyVisitElemsOfTypeCvrefParallel(const T &input, R init, F &&func, Reduce &&reduce, const ParallelVisitOptions &options = {})
+    {
+        return (RecursivelyVisitElemsMatchingPredParallel<PredTypeMatchesElemCvref<Elem>, Flags | IterationFlags::predicate_finds_bases>)(input, std::move(init), EM_FWD(func), EM_FWD(reduce), options);
+    }
+}
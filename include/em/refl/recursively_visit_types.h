@@ -24,9 +24,9 @@ namespace em::Refl
                     func.template operator()<T>();
 
                 // Returning `auto` here as well, just in case, to ensure we always instantiate the body.
-                (VisitTypes<T, Meta::LoopSimple, Mode>)([&]<typename SubT, VisitDesc Desc> -> auto
+                Meta::ConstForEach<Meta::LoopSimple>(ChildTypes<T, Mode>{}, [&]<typename Child> -> auto
                 {
-                    (Visit<SubT, Flags & ~IterationFlags::ignore_root, Filter, Desc::mode>)(func); // Can't forward `func` in a loop.
+                    (Visit<typename Child::type, Flags & ~IterationFlags::ignore_root, Filter, Child::desc::mode>)(func); // Can't forward `func` in a loop.
                 });
             }
         }
@@ -50,9 +50,9 @@ namespace em::Refl
 
                     // Recurse into non-static types.
                     // Returning `auto` here as well, just in case, to ensure we always instantiate the body.
-                    (VisitTypes<T, Meta::LoopSimple, Mode>)([&]<typename SubT, VisitDesc Desc> -> auto
+                    Meta::ConstForEach<Meta::LoopSimple>(ChildTypes<T, Mode>{}, [&]<typename Child> -> auto
                     {
-                        (Visit<SubT, Flags & ~IterationFlags::ignore_root, Filter, Desc::mode>)(func); // Can't forward `func` in a loop.
+                        (Visit<typename Child::type, Flags & ~IterationFlags::ignore_root, Filter, Child::desc::mode>)(func); // Can't forward `func` in a loop.
                     });
                 }
 
@@ -101,12 +101,52 @@ namespace em::Refl
         Meta::Stateful::Flag::value<detail::RecursivelyVisitTypes::ContainsTypeTag<detail::RecursivelyVisitTypes::AdjustType<T>, Strategy, Pred, Flags, Filter, Mode>>
     );
 
+    namespace detail::RecursivelyVisitTypes
+    {
+        // A non-stateful version of `TypeRecursivelyContainsPredWithStrategy<..., RecursiveTypeVisitorNonStatic, ...>`.
+        // This has one specialization per type node, combining the results of the subobjects bottom-up, so each node is visited at most once
+        //   per `Pred, Filter, Mode` in a TU, no matter how many times it's queried, and from how many enclosing types.
+        // The stateful version has to revisit the whole subtree for every query, which is quadratic in the tree depth if you query every level,
+        //   like `RecursivelyVisitElemsMatchingPred()` does.
+        template <typename T, Meta::TypePredicate Pred, Meta::TypePredicate Filter, VisitMode Mode>
+        struct Contains
+        {
+            // Whether any subobject type of `T` matches, not counting `T` itself.
+            static constexpr bool in_subobjects = []{
+                if constexpr (!Filter::template type<T>::value)
+                    return false;
+                else
+                    return []<typename ...Child>(Meta::TypeList<Child...>){return (Contains<typename Child::type, Pred, Filter, Child::desc::mode>::value || ...);}(ChildTypes<T, Mode>{});
+            }();
+
+            // Whether `T` or any of its subobject types matches.
+            static constexpr bool value = []{
+                if constexpr (!Filter::template type<T>::value)
+                    return false;
+                else if constexpr (Pred::template type<T>::value)
+                    return true;
+                else
+                    return in_subobjects;
+            }();
+        };
+
+        // Selects one of the members of `Contains`, without instantiating the other one.
+        template <typename T, Meta::TypePredicate Pred, IterationFlags Flags, Meta::TypePredicate Filter, VisitMode Mode>
+        constexpr bool contains = []{
+            if constexpr (bool(Flags & IterationFlags::ignore_root))
+                return Contains<AdjustType<T>, Pred, Filter, Mode>::in_subobjects;
+            else
+                return Contains<AdjustType<T>, Pred, Filter, Mode>::value;
+        }();
+    }
+
     // Returns true if `T` recrusively contains at least one element type matching `Pred`.
     // By default `T` itself also counts, unless you specify `Flags::ignore_root`.
     // `Filter` rejects whole tree branches. If it's false, the `Pred` is not checked.
     // `&&` on T` is implied.
+    // This gives the same results as `TypeRecursivelyContainsPredWithStrategy<T, RecursiveTypeVisitorNonStatic, ...>`, but is memoized per type node, see above.
     template <typename T, typename/*TypePredicate*/ Pred, IterationFlags Flags = {}, typename/*TypePredicate*/ Filter = Meta::true_predicate, VisitMode Mode = VisitMode::normal>
-    concept TypeRecursivelyContainsPred = TypeRecursivelyContainsPredWithStrategy<T, RecursiveTypeVisitorNonStatic, Pred, Flags, Filter, Mode>;
+    concept TypeRecursivelyContainsPred = detail::RecursivelyVisitTypes::contains<T, Pred, Flags, Filter, Mode>;
 
     // Same, but for static types.
     // By default also effectively checks the non-static `TypeRecursivelyContainsPred`, unless you pass `IterationFlags::root_is_not_static`.
@@ -0,0 +1,309 @@
+#pragma once
+
+#include "em/macros/utils/forward.h"
+#include "em/meta/common.h"
+#include "em/meta/const_for.h"
+#include "em/refl/bulk_copyable.h"
+#include "em/refl/classify.h"
+#include "em/refl/common.h"
+#include "em/refl/visit_members.h"
+#include "em/refl/visit_types.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <span>
+#include <stdexcept> // IWYU pragma: keep, clearly used below.
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// A simple binary serializer for reflected types.
+// The format is the concatenation of all leaf elements in the `VisitMembers()` order, in the native byte order, without any padding.
+// Range sizes are written as `std::uint64_t`, variant indices as `std::uint32_t`, and the presence of a value in nullable indirect types as a single byte.
+// This isn't portable across architectures, and doesn't validate the input beyond checking the range sizes, variant indices and `bool`s.
+//
+// The subtrees that are `BulkCopyable` (see `em/refl/bulk_copyable.h`) are written with a single copy, instead of visiting them member by member.
+// Same for contiguous ranges of such elements.
+
+namespace em::Refl::Binary
+{
+    // Receives the serialized bytes.
+    template <typename T>
+    concept Output = requires(T &t, const void *data, std::size_t size){t(data, size);};
+
+    // Produces the bytes to deserialize. Must throw if there's not enough data.
+    // Can optionally have `.Remaining()` returning the number of bytes left. Then we reject the range sizes that can't fit in them
+    //   before allocating the memory for the elements, otherwise a corrupted size can make us allocate a lot of memory.
+    template <typename T>
+    concept Input = requires(T &t, void *data, std::size_t size){t(data, size);};
+
+    // An `Output` that appends to a vector.
+    struct VectorOutput
+    {
+        std::vector<unsigned char> *bytes = nullptr;
+
+        void operator()(const void *data, std::size_t size) const
+        {
+            bytes->insert(bytes->end(), static_cast<const unsigned char *>(data), static_cast<const unsigned char *>(data) + size);
+        }
+    };
+
+    // An `Input` that consumes bytes from the front of a span.
+    struct SpanInput
+    {
+        std::span<const unsigned char> bytes;
+
+        [[nodiscard]] std::size_t Remaining() const
+        {
+            return bytes.size();
+        }
+
+        void operator()(void *data, std::size_t size)
+        {
+            if (size > bytes.size())
+                throw std::runtime_error(fmt::format("Binary deserialization: unexpected end of input, need {} more bytes but only {} remain.", size, bytes.size()));
+            std::memcpy(data, bytes.data(), size);
+            bytes = bytes.subspan(size);
+        }
+    };
+
+
+    namespace detail
+    {
+        // The type we deserialize the range elements into, before inserting them into a range that can't be modified in place.
+        // For maps we have to remove the constness from the keys.
+        template <typename T>
+        struct InsertableElementType {using type = std::ranges::range_value_t<T>;};
+        template <typename T> requires requires{typename T::key_type; typename T::mapped_type;}
+        struct InsertableElementType<T> {using type = std::pair<typename T::key_type, typename T::mapped_type>;};
+
+        // A lower bound on the number of bytes `WriteLow()` produces for `T`.
+        template <typename T, VisitMode Mode = VisitMode::normal>
+        constexpr std::size_t min_encoded_size = []{
+            constexpr Category c = classify_opt<T>;
+
+            if constexpr (BulkCopyable<T>)
+                return sizeof(T);
+            else if constexpr (c == Category::indirect && !Indirect::AlwaysHasValue<T>)
+                return std::size_t(1);
+            else if constexpr (c == Category::range)
+                return sizeof(std::uint64_t);
+            else if constexpr (c == Category::variant)
+                return sizeof(std::uint32_t);
+            else
+                return []<typename ...Child>(Meta::TypeList<Child...>){return (std::size_t(0) + ... + min_encoded_size<std::remove_cvref_t<typename Child::type>, Child::desc::mode>);}(ChildTypes<T, Mode>{});
+        }();
+
+        // Throws if `size` elements of type `Elem` can't fit in the rest of the input. Does nothing if the input doesn't know how much is left.
+        // The elements that encode to zero bytes are counted as one byte, so their number is bounded too.
+        template <typename Elem, Meta::Deduce..., Input In>
+        void CheckRangeSize(const In &input, std::uint64_t size)
+        {
+            if constexpr (requires{{input.Remaining()} -> std::convertible_to<std::size_t>;})
+            {
+                constexpr std::size_t elem_size = std::max(min_encoded_size<Elem>, std::size_t(1));
+                const std::size_t remaining = input.Remaining();
+                if (size > remaining / elem_size)
+                    throw std::runtime_error(fmt::format("Binary deserialization: range size {} can't fit in the remaining {} bytes.", size, remaining));
+            }
+            else
+            {
+                (void)input;
+                (void)size;
+            }
+        }
+
+        // Throws if the bytes just read into `count` objects of type `T` have invalid `bool`s. Then resets those bytes, to not leave invalid objects behind.
+        template <typename T>
+        void ValidateBulk(T *data, std::size_t count)
+        {
+            if constexpr (BulkCopyableNeedsValidation<T>)
+            {
+                if (!BulkBytesAreValid<T>(data, count))
+                {
+                    std::memset(static_cast<void *>(data), 0, count * sizeof(T));
+                    throw std::runtime_error("Binary deserialization: invalid `bool` value.");
+                }
+            }
+            else
+            {
+                (void)data;
+                (void)count;
+            }
+        }
+
+        template <VisitMode Mode = VisitMode::normal, Meta::Deduce..., Output Out, typename T>
+        void WriteLow(Out &output, const T &value)
+        {
+            constexpr Category c = classify_opt<T>;
+
+            if constexpr (BulkCopyable<T>)
+            {
+                output(&value, sizeof(T));
+            }
+            else if constexpr (c == Category::indirect && !Indirect::AlwaysHasValue<T>)
+            {
+                const unsigned char has_value = Indirect::HasValue(value);
+                output(&has_value, 1);
+                if (has_value)
+                    (WriteLow)(output, Indirect::GetValue(value));
+            }
+            else if constexpr (c == Category::range)
+            {
+                const std::uint64_t size = std::uint64_t(std::ranges::distance(value));
+                output(&size, sizeof(size));
+
+                if constexpr (ContiguousBulkRange<const T>)
+                    output(std::ranges::data(value), std::size_t(size) * sizeof(std::ranges::range_value_t<T>));
+                else
+                    (VisitMembers<Meta::LoopSimple>)(value, [&]<VisitDesc Desc>(const auto &elem){(WriteLow<Desc::mode>)(output, elem);});
+            }
+            else if constexpr (c == Category::variant)
+            {
+                const std::uint32_t index = std::uint32_t(value.index());
+                output(&index, sizeof(index));
+                (VisitMembers<Meta::LoopSimple>)(value, [&]<VisitDesc Desc>(const auto &alt){(WriteLow<Desc::mode>)(output, alt);});
+            }
+            else if constexpr (c != Category::unknown)
+            {
+                (VisitMembers<Meta::LoopSimple, IterationFlags{}, Mode>)(value, [&]<VisitDesc Desc>(const auto &member){(WriteLow<Desc::mode>)(output, member);});
+            }
+            else
+            {
+                static_assert(Meta::always_false<T>, "Don't know how to serialize this type.");
+            }
+        }
+
+        template <VisitMode Mode = VisitMode::normal, Meta::Deduce..., Input In, typename T>
+        void ReadLow(In &input, T &value)
+        {
+            static_assert(!std::is_const_v<T>, "Can't deserialize into a const object.");
+
+            constexpr Category c = classify_opt<T>;
+
+            if constexpr (BulkCopyable<T>)
+            {
+                input(&value, sizeof(T));
+                ValidateBulk(&value, 1);
+            }
+            else if constexpr (c == Category::indirect && !Indirect::AlwaysHasValue<T>)
+            {
+                unsigned char has_value = 0;
+                input(&has_value, 1);
+
+                static_assert(requires{value.reset(); value.emplace();}, "Can only deserialize nullable indirect types that have `.emplace()` and `.reset()`, such as `std::optional`.");
+                if (has_value)
+                {
+                    value.emplace();
+                    (ReadLow)(input, Indirect::GetValue(value));
+                }
+                else
+                {
+                    value.reset();
+                }
+            }
+            else if constexpr (c == Category::range)
+            {
+                std::uint64_t size = 0;
+                input(&size, sizeof(size));
+
+                if constexpr (requires{value.resize(std::size_t(size));})
+                {
+                    CheckRangeSize<std::ranges::range_value_t<T>>(input, size);
+                    value.resize(std::size_t(size));
+                    if constexpr (ContiguousBulkRange<T>)
+                    {
+                        input(std::ranges::data(value), std::size_t(size) * sizeof(std::ranges::range_value_t<T>));
+                        ValidateBulk(std::ranges::data(value), std::size_t(size));
+                    }
+                    else
+                        (VisitMembers<Meta::LoopSimple>)(value, [&]<VisitDesc Desc>(auto &elem){(ReadLow<Desc::mode>)(input, elem);});
+                }
+                else if constexpr (requires(typename InsertableElementType<T>::type &&elem){value.clear(); value.insert(value.end(), std::move(elem));})
+                {
+                    // This handles sets and maps, where the elements can't be modified in place.
+                    // These grow one element at a time, so the size check is only for an early error.
+                    CheckRangeSize<typename InsertableElementType<T>::type>(input, size);
+                    value.clear();
+                    for (std::uint64_t i = 0; i < size; i++)
+                    {
+                        typename InsertableElementType<T>::type elem{};
+                        (ReadLow)(input, elem);
+                        value.insert(value.end(), std::move(elem));
+                    }
+                }
+                else
+                {
+                    // A fixed-size range.
+                    if (size != std::uint64_t(std::ranges::distance(value)))
+                        throw std::runtime_error(fmt::format("Binary deserialization: expected a range of size {}, but got {}.", std::ranges::distance(value), size));
+                    (VisitMembers<Meta::LoopSimple>)(value, [&]<VisitDesc Desc>(auto &elem){(ReadLow<Desc::mode>)(input, elem);});
+                }
+            }
+            else if constexpr (c == Category::variant)
+            {
+                std::uint32_t index = 0;
+                input(&index, sizeof(index));
+                bool found = Meta::ConstFor<Meta::LoopAnyOf<>, std::variant_size_v<T>>([&]<std::size_t I> -> bool
+                {
+                    if (index != I)
+                        return false;
+                    value.template emplace<I>();
+                    (ReadLow)(input, Variants::Get<I>(value));
+                    return true;
+                });
+                if (!found)
+                    throw std::runtime_error(fmt::format("Binary deserialization: variant index {} is out of range.", index));
+            }
+            else if constexpr (c != Category::unknown)
+            {
+                (VisitMembers<Meta::LoopSimple, IterationFlags{}, Mode>)(value, [&]<VisitDesc Desc>(auto &member){(ReadLow<Desc::mode>)(input, member);});
+            }
+            else
+            {
+                static_assert(Meta::always_false<T>, "Don't know how to deserialize this type.");
+            }
+        }
+    }
+
+    // Serializes `value`, passing the bytes to `output`.
+    template <Meta::Deduce..., typename T, Output Out>
+    void Write(const T &value, Out &&output)
+    {
+        (detail::WriteLow)(output, value);
+    }
+
+    // Deserializes `value` in place, receiving the bytes from `input`.
+    // Throws on failure, in which case `value` is left in an unspecified (but valid) state.
+    template <Meta::Deduce..., typename T, Input In>
+    void Read(T &value, In &&input)
+    {
+        (detail::ReadLow)(input, value);
+    }
+
+    // Serializes `value` to a vector of bytes.
+    template <Meta::Deduce..., typename T>
+    [[nodiscard]] std::vector<unsigned char> ToBytes(const T &value)
+    {
+        std::vector<unsigned char> ret;
+        Write(value, VectorOutput{&ret});
+        return ret;
+    }
+
+    // Deserializes `value` from `bytes`. Throws if the input is invalid, or if there are unused bytes at the end.
+    template <Meta::Deduce..., typename T>
+    void FromBytes(T &value, std::span<const unsigned char> bytes)
+    {
+        SpanInput input{bytes};
+        Read(value, input);
+        if (!input.bytes.empty())
+            throw std::runtime_error(fmt::format("Binary deserialization: {} unused bytes at the end of input.", input.bytes.size()));
+    }
+}
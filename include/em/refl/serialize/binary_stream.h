@@ -0,0 +1,373 @@
+#pragma once
+
+#include "em/meta/common.h"
+#include "em/meta/const_for.h"
+#include "em/refl/bulk_copyable.h"
+#include "em/refl/classify.h"
+#include "em/refl/common.h"
+#include "em/refl/serialize/binary.h"
+#include "em/refl/visit_types.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept> // IWYU pragma: keep, clearly used below.
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// An incremental version of `Binary::Read()` (see `em/refl/serialize/binary.h`), for reading objects as the data arrives in chunks of arbitrary size.
+// Construct `Binary::StreamReader` with the target object, then `Feed()` it the chunks until `Done()` returns true.
+// The bytes go straight into the target object, so there's no need to buffer the whole message first.
+//
+// The reader keeps an explicit stack of the objects being filled, in the same order as `VisitMembers()`, which is also the order used by `Binary::Write()`.
+// The target object must outlive the reader, and must not be touched until the reader is done.
+
+namespace em::Refl::Binary
+{
+    class StreamReader
+    {
+        struct Frame
+        {
+            // Advances this frame, possibly consuming input. Returns false if it needs more input.
+            // It can push one more frame (which makes `frame` dangling), or pop itself.
+            bool (*step)(StreamReader &reader, Frame &frame) = nullptr;
+            // The object being filled.
+            void *object = nullptr;
+            // The number of bytes read, or the member index, or the element index, depending on the type.
+            std::uint64_t pos = 0;
+            // The number of bytes in a raw block, or the number of range elements.
+            std::uint64_t size = 0;
+            // What we're doing in this frame, the meaning depends on the type.
+            int state = 0;
+            // The range sizes, variant indices, etc are read here, since they can be split between chunks.
+            unsigned char header[sizeof(std::uint64_t)]{};
+            // A temporary element, for the ranges that can't be filled in place.
+            std::unique_ptr<void, void (*)(void *)> temp{nullptr, nullptr};
+        };
+
+        std::vector<Frame> stack;
+        std::span<const unsigned char> input;
+        bool failed = false;
+
+        // Copies up to `size` bytes from the current chunk. Returns the number of bytes copied.
+        std::size_t ReadSome(void *data, std::size_t size)
+        {
+            std::size_t n = std::min(size, input.size());
+            if (n > 0)
+            {
+                std::memcpy(data, input.data(), n);
+                input = input.subspan(n);
+            }
+            return n;
+        }
+
+        // Reads a header of type `H` into `frame.header`, using `frame.pos` to track the progress. Returns false if it needs more input.
+        // On success, resets `frame.pos` to zero.
+        template <typename H>
+        bool ReadHeader(Frame &frame, H &header)
+        {
+            static_assert(sizeof(H) <= sizeof(Frame::header));
+            frame.pos += ReadSome(frame.header + frame.pos, sizeof(H) - std::size_t(frame.pos));
+            if (frame.pos < sizeof(H))
+                return false;
+            std::memcpy(&header, frame.header, sizeof(H));
+            frame.pos = 0;
+            return true;
+        }
+
+        void Pop()
+        {
+            stack.pop_back();
+        }
+
+        template <typename T>
+        static bool StepRaw(StreamReader &reader, Frame &frame)
+        {
+            frame.pos += reader.ReadSome(static_cast<unsigned char *>(frame.object) + frame.pos, std::size_t(frame.size - frame.pos));
+            if (frame.pos < frame.size)
+                return false;
+            detail::ValidateBulk(static_cast<T *>(frame.object), std::size_t(frame.size / sizeof(T)));
+            reader.Pop();
+            return true;
+        }
+
+        // Pushes `count` objects of a `BulkCopyable` type, which are read as raw bytes.
+        template <typename T>
+        void PushRaw(T *data, std::size_t count)
+        {
+            if (count > 0)
+                stack.push_back({.step = StepRaw<T>, .object = data, .size = count * sizeof(T)});
+        }
+
+        // Pushes `value`, which is read according to its type.
+        template <VisitMode Mode = VisitMode::normal, Meta::Deduce..., typename T>
+        void Push(T &value)
+        {
+            static_assert(!std::is_const_v<T>, "Can't deserialize into a const object.");
+
+            if constexpr (BulkCopyable<T>)
+                PushRaw(&value, 1);
+            else
+                stack.push_back({.step = Step<T, Mode>, .object = &value});
+        }
+
+        // Pushes the subobject `SubT` of a struct, described by `Desc` (as given by `VisitTypes()`).
+        template <typename T, typename SubT, typename Desc>
+        static void PushStructChild(StreamReader &reader, void *object)
+        {
+            T &value = *static_cast<T *>(object);
+            if constexpr (std::derived_from<Desc, VisitingAnyBase>)
+                (reader.Push<Desc::mode>)(Bases::CastToBase<std::remove_cvref_t<SubT>>(value));
+            else
+                (reader.Push<Desc::mode>)(Structs::GetMemberMutable<Desc::value>(value));
+        }
+
+        // For every subobject of a struct, a function that pushes it.
+        template <typename T, VisitMode Mode>
+        static constexpr auto struct_children = []{
+            constexpr int n = []{
+                int ret = 0;
+                (VisitTypes<T, Meta::LoopSimple, Mode>)([&]<typename SubT, VisitDesc Desc>{ret++;});
+                return ret;
+            }();
+
+            std::array<void (*)(StreamReader &, void *), n> ret{};
+            int i = 0;
+            (VisitTypes<T, Meta::LoopSimple, Mode>)([&]<typename SubT, VisitDesc Desc>{ret[i++] = PushStructChild<T, SubT, Desc>;});
+            return ret;
+        }();
+
+        template <typename T, VisitMode Mode>
+        static bool Step(StreamReader &reader, Frame &frame)
+        {
+            T &value = *static_cast<T *>(frame.object);
+
+            constexpr Category c = classify_opt<T>;
+
+            if constexpr (c == Category::adjust)
+            {
+                static_assert(std::is_lvalue_reference_v<Adjust::AdjustedType<T &>>, "Can only deserialize the adjusted types that are lvalue references.");
+                auto &adjusted = Adjust::Adjust(value);
+                reader.Pop();
+                reader.Push(adjusted);
+                return true;
+            }
+            else if constexpr (c == Category::structure)
+            {
+                constexpr auto &children = struct_children<T, Mode>;
+                if (frame.pos == children.size())
+                {
+                    reader.Pop();
+                    return true;
+                }
+                children[std::size_t(frame.pos++)](reader, &value);
+                return true;
+            }
+            else if constexpr (c == Category::indirect && Indirect::AlwaysHasValue<T>)
+            {
+                static_assert(std::is_lvalue_reference_v<Indirect::ValueTypeCvref<T &>>, "Can only deserialize the indirect types that return lvalue references.");
+                auto &target = Indirect::GetValue(value);
+                reader.Pop();
+                reader.Push(target);
+                return true;
+            }
+            else if constexpr (c == Category::indirect)
+            {
+                static_assert(requires{value.reset(); value.emplace();}, "Can only deserialize nullable indirect types that have `.emplace()` and `.reset()`, such as `std::optional`.");
+                // State 0: reading the flag. State 1: reading the value.
+                if (frame.state == 1)
+                {
+                    reader.Pop();
+                    return true;
+                }
+
+                unsigned char has_value = 0;
+                if (!reader.ReadHeader(frame, has_value))
+                    return false;
+
+                if (has_value)
+                {
+                    value.emplace();
+                    frame.state = 1;
+                    reader.Push(Indirect::GetValue(value));
+                }
+                else
+                {
+                    value.reset();
+                    reader.Pop();
+                }
+                return true;
+            }
+            else if constexpr (c == Category::range)
+            {
+                // State 0: reading the size. State 1: reading the elements in place.
+                // State 2: reading the elements into `frame.temp`, and inserting them after that. State 3: reading such element.
+                using Elem = typename detail::InsertableElementType<T>::type;
+                constexpr bool in_place = std::ranges::random_access_range<T>;
+                constexpr bool resizable = in_place && requires{value.resize(std::size_t{});};
+
+                if (frame.state == 0)
+                {
+                    std::uint64_t size = 0;
+                    if (!reader.ReadHeader(frame, size))
+                        return false;
+
+                    if constexpr (resizable)
+                    {
+                        // We don't trust `size` yet, so the range grows as the elements arrive, see below.
+                        value.resize(0);
+                    }
+                    else if constexpr (in_place)
+                    {
+                        // A fixed-size range.
+                        if (size != std::uint64_t(std::ranges::distance(value)))
+                            throw std::runtime_error(fmt::format("Binary deserialization: expected a range of size {}, but got {}.", std::ranges::distance(value), size));
+                    }
+                    else if constexpr (requires(Elem &&elem){value.clear(); value.insert(value.end(), std::move(elem));})
+                    {
+                        value.clear();
+                    }
+                    else
+                    {
+                        static_assert(Meta::always_false<T>, "Don't know how to deserialize this range.");
+                    }
+
+                    frame.size = size;
+                    frame.state = in_place ? 1 : 2;
+                    return true;
+                }
+                else if (frame.state == 3)
+                {
+                    value.insert(value.end(), std::move(*static_cast<Elem *>(frame.temp.get())));
+                    frame.temp.reset();
+                    frame.pos++;
+                    frame.state = 2;
+                    return true;
+                }
+                else if (frame.pos == frame.size)
+                {
+                    reader.Pop();
+                    return true;
+                }
+                else if constexpr (in_place)
+                {
+                    if constexpr (resizable)
+                    {
+                        // Grow geometrically, so a corrupted size can only make us allocate a few times more than the input we actually received.
+                        // Since only the top frame runs, the elements read before are complete, so it's fine to reallocate them.
+                        if (frame.pos == std::uint64_t(std::ranges::size(value)))
+                        {
+                            constexpr std::uint64_t min_growth = std::max(std::size_t(1), std::size_t(4096) / sizeof(std::ranges::range_value_t<T>));
+                            value.resize(std::size_t(std::min(frame.size, frame.pos + std::max(frame.pos, min_growth))));
+                        }
+
+                        if constexpr (ContiguousBulkRange<T>)
+                        {
+                            // Read all the allocated elements as a single raw block.
+                            const std::size_t begin = std::size_t(frame.pos);
+                            frame.pos = std::uint64_t(std::ranges::size(value));
+                            reader.PushRaw(std::ranges::data(value) + begin, std::size_t(frame.pos) - begin);
+                            return true;
+                        }
+                    }
+
+                    auto &elem = std::ranges::begin(value)[std::ptrdiff_t(frame.pos++)];
+                    reader.Push(elem);
+                    return true;
+                }
+                else
+                {
+                    frame.temp = {new Elem{}, [](void *p){delete static_cast<Elem *>(p);}};
+                    frame.state = 3;
+                    reader.Push(*static_cast<Elem *>(frame.temp.get()));
+                    return true;
+                }
+            }
+            else if constexpr (c == Category::variant)
+            {
+                // State 0: reading the index. State 1: reading the alternative.
+                if (frame.state == 1)
+                {
+                    reader.Pop();
+                    return true;
+                }
+
+                std::uint32_t index = 0;
+                if (!reader.ReadHeader(frame, index))
+                    return false;
+
+                frame.state = 1;
+                bool found = Meta::ConstFor<Meta::LoopAnyOf<>, std::variant_size_v<T>>([&]<std::size_t I> -> bool
+                {
+                    if (index != I)
+                        return false;
+                    value.template emplace<I>();
+                    reader.Push(Variants::Get<I>(value));
+                    return true;
+                });
+                if (!found)
+                    throw std::runtime_error(fmt::format("Binary deserialization: variant index {} is out of range.", index));
+                return true;
+            }
+            else
+            {
+                static_assert(Meta::always_false<T>, "Don't know how to deserialize this type.");
+            }
+        }
+
+      public:
+        // Prepares to read into `target`.
+        template <Meta::Deduce..., typename T> requires(!std::is_same_v<T, StreamReader>)
+        explicit StreamReader(T &target)
+        {
+            Push(target);
+        }
+
+        StreamReader(StreamReader &&) = default;
+        StreamReader &operator=(StreamReader &&) = default;
+
+        // Returns true when the target object is fully read.
+        [[nodiscard]] bool Done() const
+        {
+            return stack.empty();
+        }
+
+        // Reads the next chunk of input. Stops when the target object is done, and returns the number of bytes consumed,
+        //   which is less than `chunk.size()` only if the object is done and there are extra bytes.
+        // Throws on invalid input. After that the reader can't be used anymore, and the target object is left in an unspecified (but valid) state.
+        std::size_t Feed(std::span<const unsigned char> chunk)
+        {
+            if (failed)
+                throw std::runtime_error("Binary deserialization: can't continue after an error.");
+
+            input = chunk;
+            try
+            {
+                while (!stack.empty() && stack.back().step(*this, stack.back())) {}
+            }
+            catch (...)
+            {
+                failed = true;
+                throw;
+            }
+            return chunk.size() - input.size();
+        }
+
+        // Throws if the target object isn't fully read yet. Call this when there's no more input.
+        void Finish() const
+        {
+            if (!Done())
+                throw std::runtime_error("Binary deserialization: unexpected end of input.");
+        }
+    };
+}
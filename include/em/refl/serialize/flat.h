@@ -0,0 +1,620 @@
+#pragma once
+
+#include "em/meta/common.h"
+#include "em/meta/const_for.h"
+#include "em/refl/bulk_copyable.h"
+#include "em/refl/classify.h"
+#include "em/refl/common.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <ranges>
+#include <span>
+#include <stdexcept> // IWYU pragma: keep, clearly used below.
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// A flat, offset-based binary format for reflected types, which can be accessed in place without deserializing it.
+// Write the data with `Flat::ToBytes()`, then map the file into memory (or read it into a buffer), and call `Flat::MakeView<T>()` on the bytes.
+// That validates the data once, and returns a `Flat::View<T>` that reads everything directly from the buffer.
+//
+// Every type has a fixed-size block, laid out with the natural alignment:
+// * `BulkCopyable` types (see `em/refl/bulk_copyable.h`) are stored as is, and the views return references to them.
+//   If they are structs, the views also provide the same member and base accessors as for the other structs.
+// * Structs store the blocks of their direct bases, then of their members, in the `VisitMembers()` order. Virtual bases aren't supported.
+// * Ranges store a `RelSpan`, pointing to a separately stored array of element blocks. Strings are the same, and the views return `std::string_view`s.
+// * Indirect types that can be null (`std::optional`, pointers, etc) store a `RelPtr` to the value block, or zero if there's no value.
+//   The ones that can't be null store the value block inline.
+// * Variants store a `RelVariant`, which is the index and a pointer to the alternative block.
+// All offsets are relative to the field that stores them, and always point forward, so the buffer can be moved freely.
+//
+// Like `em/refl/serialize/binary.h`, this uses the native byte order and isn't portable across architectures.
+// The buffer must be aligned at least as much as the most aligned type in it. Memory maps are page-aligned, and `new` is usually enough too.
+
+namespace em::Refl::Flat
+{
+    // Describes a range: `size` elements, starting at `offset` bytes from this object. `offset` is zero for empty ranges.
+    struct RelSpan
+    {
+        std::uint64_t offset = 0;
+        std::uint64_t size = 0;
+    };
+
+    // Points to a value `offset` bytes from this object, or to nothing if `offset` is zero.
+    struct RelPtr
+    {
+        std::uint64_t offset = 0;
+    };
+
+    // Stores a variant: the alternative index, and the alternative, `offset` bytes from this object.
+    struct RelVariant
+    {
+        std::uint64_t index = 0;
+        std::uint64_t offset = 0;
+    };
+
+    template <typename T>
+    class View;
+
+    namespace detail
+    {
+        enum class Kind
+        {
+            bulk,
+            structure,
+            range,
+            nullable, // A nullable indirect type.
+            inline_indirect, // A non-nullable indirect type.
+            variant,
+        };
+
+        template <typename T>
+        constexpr Kind kind = []{
+            constexpr Category c = classify_opt<T>;
+
+            if constexpr (BulkCopyable<T>)
+            {
+                return Kind::bulk;
+            }
+            else if constexpr (c == Category::structure)
+            {
+                return Kind::structure;
+            }
+            else if constexpr (c == Category::range)
+            {
+                return Kind::range;
+            }
+            else if constexpr (c == Category::indirect)
+            {
+                return Indirect::AlwaysHasValue<T> ? Kind::inline_indirect : Kind::nullable;
+            }
+            else if constexpr (c == Category::variant)
+            {
+                return Kind::variant;
+            }
+            else
+            {
+                static_assert(c != Category::adjust, "The flat format doesn't support adjusted types.");
+                static_assert(Meta::always_false<T>, "Don't know how to store this type in the flat format.");
+                return Kind::bulk;
+            }
+        }();
+
+        template <typename T>
+        using RangeElem = std::remove_cv_t<std::ranges::range_value_t<const T>>;
+        template <typename T>
+        using IndirectElem = std::remove_cvref_t<Indirect::ValueTypeCvref<const T &>>;
+
+        template <typename T>
+        constexpr int list_size = 0;
+        template <typename ...P>
+        constexpr int list_size<Meta::TypeList<P...>> = sizeof...(P);
+
+        // The children of a struct are its direct bases, then its members.
+        template <typename T>
+        constexpr int num_bases = list_size<Bases::NonVirtualBasesDirect<T>>;
+        template <typename T>
+        constexpr int num_children = num_bases<T> + []{
+            if constexpr (Structs::Type<T>)
+                return Structs::num_members<T>;
+            else
+                return 0; // This can happen if the type has bases but no members.
+        }();
+
+        template <typename T, int K>
+        struct ChildType {using type = Meta::list_type_at<Bases::NonVirtualBasesDirect<T>, K>;};
+        template <typename T, int K> requires(K >= num_bases<T>)
+        struct ChildType<T, K>
+        {
+            static_assert(!std::is_reference_v<Structs::MemberType<T, K - num_bases<T>>>, "The flat format doesn't support reference members.");
+            using type = std::remove_cv_t<Structs::MemberType<T, K - num_bases<T>>>;
+        };
+
+        // Returns the `K`th child of a struct.
+        template <int K, Meta::Deduce..., typename T>
+        [[nodiscard]] constexpr const typename ChildType<T, K>::type &GetChild(const T &object)
+        {
+            if constexpr (K < num_bases<T>)
+                return Bases::CastToBase<typename ChildType<T, K>::type>(object);
+            else
+                return Structs::GetMemberConst<K - num_bases<T>>(object);
+        }
+
+        template <typename T>
+        struct StructLayout;
+
+        template <typename T>
+        constexpr std::size_t flat_size = []{
+            constexpr Kind k = kind<T>;
+            if constexpr (k == Kind::bulk)
+                return sizeof(T);
+            else if constexpr (k == Kind::structure)
+                return StructLayout<T>::value.size;
+            else if constexpr (k == Kind::range)
+                return sizeof(RelSpan);
+            else if constexpr (k == Kind::nullable)
+                return sizeof(RelPtr);
+            else if constexpr (k == Kind::inline_indirect)
+                return flat_size<IndirectElem<T>>;
+            else
+                return sizeof(RelVariant);
+        }();
+
+        template <typename T>
+        constexpr std::size_t flat_alignment = []{
+            constexpr Kind k = kind<T>;
+            if constexpr (k == Kind::bulk)
+                return alignof(T);
+            else if constexpr (k == Kind::structure)
+                return StructLayout<T>::value.alignment;
+            else if constexpr (k == Kind::range)
+                return alignof(RelSpan);
+            else if constexpr (k == Kind::nullable)
+                return alignof(RelPtr);
+            else if constexpr (k == Kind::inline_indirect)
+                return flat_alignment<IndirectElem<T>>;
+            else
+                return alignof(RelVariant);
+        }();
+
+        [[nodiscard]] constexpr std::size_t AlignUp(std::size_t value, std::size_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        template <typename T>
+        struct StructLayout
+        {
+            static_assert(std::is_same_v<Bases::VirtualBasesFlat<T>, Meta::TypeList<>>, "The flat format doesn't support virtual bases.");
+
+            struct Value
+            {
+                std::array<std::size_t, num_children<T>> offsets{};
+                std::size_t size = 0;
+                std::size_t alignment = 1;
+            };
+
+            static constexpr Value value = []{
+                Value ret;
+                Meta::ConstFor<Meta::LoopSimple, num_children<T>>([&]<int K>
+                {
+                    using Child = typename ChildType<T, K>::type;
+                    ret.offsets[K] = AlignUp(ret.size, flat_alignment<Child>);
+                    ret.size = ret.offsets[K] + flat_size<Child>;
+                    ret.alignment = std::max(ret.alignment, flat_alignment<Child>);
+                });
+                // Not allowing empty blocks, to not have ranges with zero stride.
+                ret.size = AlignUp(std::max(ret.size, std::size_t(1)), ret.alignment);
+                return ret;
+            }();
+        };
+
+        template <typename T>
+        constexpr bool is_char_type = std::is_same_v<T, char> || std::is_same_v<T, wchar_t> || std::is_same_v<T, char8_t> || std::is_same_v<T, char16_t> || std::is_same_v<T, char32_t>;
+
+        class Writer
+        {
+            std::vector<unsigned char> bytes;
+
+            // Appends a zeroed block, and returns its position.
+            std::size_t Allocate(std::size_t size, std::size_t alignment)
+            {
+                std::size_t pos = AlignUp(bytes.size(), alignment);
+                bytes.resize(pos + size);
+                return pos;
+            }
+
+            template <typename R>
+            void Store(std::size_t pos, const R &value)
+            {
+                std::memcpy(bytes.data() + pos, &value, sizeof(R));
+            }
+
+            // Writes the block of `value` at `pos`. We use the positions everywhere instead of pointers, since `bytes` can be reallocated.
+            template <Meta::Deduce..., typename T>
+            void WriteAt(std::size_t pos, const T &value)
+            {
+                constexpr Kind k = kind<T>;
+
+                if constexpr (k == Kind::bulk)
+                {
+                    Store(pos, value);
+                }
+                else if constexpr (k == Kind::structure)
+                {
+                    Meta::ConstFor<Meta::LoopSimple, num_children<T>>([&]<int K>
+                    {
+                        WriteAt(pos + StructLayout<T>::value.offsets[K], (GetChild<K>)(value));
+                    });
+                }
+                else if constexpr (k == Kind::range)
+                {
+                    using Elem = RangeElem<T>;
+                    const std::size_t size = std::size_t(std::ranges::distance(value));
+                    const std::size_t elems_pos = size == 0 ? pos : Allocate(size * flat_size<Elem>, flat_alignment<Elem>);
+                    Store(pos, RelSpan{.offset = elems_pos - pos, .size = size});
+
+                    if constexpr (ContiguousBulkRange<const T>)
+                    {
+                        if (size > 0)
+                            std::memcpy(bytes.data() + elems_pos, std::ranges::data(value), size * sizeof(Elem));
+                    }
+                    else
+                    {
+                        std::size_t elem_pos = elems_pos;
+                        for (const auto &elem : value)
+                        {
+                            WriteAt(elem_pos, static_cast<const Elem &>(elem));
+                            elem_pos += flat_size<Elem>;
+                        }
+                    }
+                }
+                else if constexpr (k == Kind::nullable)
+                {
+                    if (Indirect::HasValue(value))
+                    {
+                        using Elem = IndirectElem<T>;
+                        const std::size_t elem_pos = Allocate(flat_size<Elem>, flat_alignment<Elem>);
+                        Store(pos, RelPtr{.offset = elem_pos - pos});
+                        WriteAt(elem_pos, static_cast<const Elem &>(Indirect::GetValue(value)));
+                    }
+                }
+                else if constexpr (k == Kind::inline_indirect)
+                {
+                    WriteAt(pos, static_cast<const IndirectElem<T> &>(Indirect::GetValue(value)));
+                }
+                else // k == Kind::variant
+                {
+                    // `valueless_by_exception()` is optional for variant-like types, but `index()` returns -1 in that case anyway.
+                    if (value.index() >= std::variant_size_v<T>)
+                        throw std::runtime_error("Flat serialization: the variant is valueless by exception.");
+
+                    Meta::ConstFor<Meta::LoopAnyOf<>, std::variant_size_v<T>>([&]<std::size_t I> -> bool
+                    {
+                        if (value.index() != I)
+                            return false;
+                        using Alt = std::remove_cv_t<std::variant_alternative_t<I, T>>;
+                        const std::size_t alt_pos = Allocate(flat_size<Alt>, flat_alignment<Alt>);
+                        Store(pos, RelVariant{.index = I, .offset = alt_pos - pos});
+                        WriteAt(alt_pos, static_cast<const Alt &>(Variants::Get<I>(value)));
+                        return true;
+                    });
+                }
+            }
+
+          public:
+            template <typename T>
+            [[nodiscard]] std::vector<unsigned char> Write(const T &value) &&
+            {
+                const std::size_t pos = Allocate(flat_size<T>, flat_alignment<T>);
+                WriteAt(pos, value);
+                return std::move(bytes);
+            }
+        };
+
+        // Validates the data in the same order as `Writer` writes it. Since the writer appends every block as it visits the field pointing to it,
+        //   the blocks must be disjoint and come in increasing order. We require that, which also ensures that every byte is validated at most once.
+        //   Otherwise several fields could point to the same block, and crafted data could make us validate it an exponential number of times.
+        class Validator
+        {
+            std::span<const unsigned char> bytes;
+            // The end of the last block seen so far. The next block must start at or after this.
+            std::size_t blocks_end = 0;
+
+            template <typename R>
+            [[nodiscard]] R Load(std::size_t pos) const
+            {
+                R ret;
+                std::memcpy(&ret, bytes.data() + pos, sizeof(R));
+                return ret;
+            }
+
+            // Resolves the offset stored in the field at `pos`, and checks that it points to `count` blocks of `T` that fit in the buffer,
+            //   after all the blocks seen before.
+            template <typename T>
+            [[nodiscard]] std::size_t CheckTarget(std::size_t pos, std::uint64_t offset, std::uint64_t count)
+            {
+                if (offset > bytes.size() - pos || pos + std::size_t(offset) < blocks_end)
+                    throw std::runtime_error(fmt::format("Flat data validation: offset {} at position {} is out of range, or overlaps the previous data.", offset, pos));
+                const std::size_t target = pos + std::size_t(offset);
+                CheckBlock<T>(target, count);
+                return target;
+            }
+
+          public:
+            explicit Validator(std::span<const unsigned char> bytes) : bytes(bytes) {}
+
+            // Checks that `count` blocks of `T` starting at `pos` fit in the buffer, and are properly aligned. Marks them as seen.
+            template <typename T>
+            void CheckBlock(std::size_t pos, std::uint64_t count)
+            {
+                if (count > (bytes.size() - pos) / flat_size<T>)
+                    throw std::runtime_error(fmt::format("Flat data validation: {} elements of {} bytes at position {} don't fit in {} bytes.", count, flat_size<T>, pos, bytes.size()));
+                if ((reinterpret_cast<std::uintptr_t>(bytes.data()) + pos) % flat_alignment<T> != 0)
+                    throw std::runtime_error(fmt::format("Flat data validation: the data at position {} isn't aligned to {} bytes.", pos, flat_alignment<T>));
+                blocks_end = pos + std::size_t(count) * flat_size<T>;
+            }
+
+            // Validates the block of `T` at `pos`. It must already be checked with `CheckBlock()`.
+            template <typename T>
+            void ValidateAt(std::size_t pos)
+            {
+                constexpr Kind k = kind<T>;
+
+                if constexpr (k == Kind::bulk)
+                {
+                    if (!BulkBytesAreValid<T>(bytes.data() + pos))
+                        throw std::runtime_error(fmt::format("Flat data validation: invalid `bool` value in the block at position {}.", pos));
+                }
+                else if constexpr (k == Kind::structure)
+                {
+                    Meta::ConstFor<Meta::LoopSimple, num_children<T>>([&]<int K>
+                    {
+                        ValidateAt<typename ChildType<T, K>::type>(pos + StructLayout<T>::value.offsets[K]);
+                    });
+                }
+                else if constexpr (k == Kind::range)
+                {
+                    using Elem = RangeElem<T>;
+                    const auto span = Load<RelSpan>(pos);
+                    if (span.size == 0)
+                        return;
+                    const std::size_t elems_pos = CheckTarget<Elem>(pos, span.offset, span.size);
+                    if constexpr (kind<Elem> != Kind::bulk || BulkCopyableNeedsValidation<Elem>)
+                    {
+                        for (std::size_t i = 0; i < span.size; i++)
+                            ValidateAt<Elem>(elems_pos + i * flat_size<Elem>);
+                    }
+                }
+                else if constexpr (k == Kind::nullable)
+                {
+                    using Elem = IndirectElem<T>;
+                    const auto ptr = Load<RelPtr>(pos);
+                    if (ptr.offset != 0)
+                        ValidateAt<Elem>(CheckTarget<Elem>(pos, ptr.offset, 1));
+                }
+                else if constexpr (k == Kind::inline_indirect)
+                {
+                    ValidateAt<IndirectElem<T>>(pos);
+                }
+                else // k == Kind::variant
+                {
+                    const auto var = Load<RelVariant>(pos);
+                    bool found = Meta::ConstFor<Meta::LoopAnyOf<>, std::variant_size_v<T>>([&]<std::size_t I> -> bool
+                    {
+                        if (var.index != I)
+                            return false;
+                        using Alt = std::remove_cv_t<std::variant_alternative_t<I, T>>;
+                        ValidateAt<Alt>(CheckTarget<Alt>(pos, var.offset, 1));
+                        return true;
+                    });
+                    if (!found)
+                        throw std::runtime_error(fmt::format("Flat data validation: variant index {} at position {} is out of range.", var.index, pos));
+                }
+            }
+        };
+    }
+
+    // Serializes `value` to the flat format.
+    template <Meta::Deduce..., typename T>
+    [[nodiscard]] std::vector<unsigned char> ToBytes(const T &value)
+    {
+        return detail::Writer{}.Write(value);
+    }
+
+    // Checks that `bytes` contain valid flat data of type `T`: every offset points inside the buffer, the blocks are aligned and don't overlap
+    //   (in the order `ToBytes()` writes them), the variant indices are in range, and the `bool`s are zero or one. Throws on failure.
+    // This takes time linear in the size of the data.
+    // Extra bytes at the end are allowed, since memory maps are rounded up to the page size.
+    template <typename T>
+    void Validate(std::span<const unsigned char> bytes)
+    {
+        static_assert(Meta::cvref_unqualified<T>, "The type must not be cvref-qualified.");
+        detail::Validator validator(bytes);
+        validator.CheckBlock<T>(0, 1);
+        validator.ValidateAt<T>(0);
+    }
+
+    // Validates `bytes`, then returns a view of the root object. The view points into `bytes` and doesn't own it.
+    template <typename T>
+    [[nodiscard]] View<T> MakeView(std::span<const unsigned char> bytes)
+    {
+        Validate<T>(bytes);
+        return View<T>(bytes.data());
+    }
+
+    // Returns a view of the root object without validation. Only use this on data you've already validated, or that you trust.
+    template <typename T>
+    [[nodiscard]] View<T> MakeViewUnchecked(const unsigned char *data)
+    {
+        return View<T>(data);
+    }
+
+    // Reads a flat object of type `T` in place. This is a non-owning pointer-like handle, and is cheap to copy.
+    // The available accessors depend on the type category, see the comment at the beginning of the file.
+    template <typename T>
+    class View
+    {
+        static_assert(Meta::cvref_unqualified<T>, "The type must not be cvref-qualified.");
+
+        static constexpr detail::Kind kind = detail::kind<T>;
+
+        const unsigned char *data = nullptr;
+
+        template <typename R>
+        [[nodiscard]] R Load() const
+        {
+            R ret;
+            std::memcpy(&ret, data, sizeof(R));
+            return ret;
+        }
+
+      public:
+        constexpr View() = default;
+        constexpr explicit View(const unsigned char *data) : data(data) {}
+
+        // The block of this object.
+        [[nodiscard]] constexpr const unsigned char *Data() const {return data;}
+
+        // --- `BulkCopyable` types:
+
+        [[nodiscard]] const T &Value() const requires(kind == detail::Kind::bulk)
+        {
+            return *std::launder(reinterpret_cast<const T *>(data));
+        }
+
+        // --- Structs, including the `BulkCopyable` ones, so the accessors don't change when a member makes the struct bulk-copyable or not:
+
+        // The `I`th non-static member.
+        // For `BulkCopyable` structs this needs `Structs::HasMemberLayout<T>`, which `EM_REFL()` provides for them.
+        template <int I> requires(kind == detail::Kind::structure || (kind == detail::Kind::bulk && Structs::HasMemberLayout<T>)) && Structs::ValidMemberIndex<T, I>
+        [[nodiscard]] View<typename detail::ChildType<T, detail::num_bases<T> + I>::type> GetMember() const
+        {
+            if constexpr (kind == detail::Kind::structure)
+                return View<typename detail::ChildType<T, detail::num_bases<T> + I>::type>(data + detail::StructLayout<T>::value.offsets[detail::num_bases<T> + I]);
+            else
+                return View<typename detail::ChildType<T, detail::num_bases<T> + I>::type>(data + Structs::MemberLayout<T>()[I].offset);
+        }
+
+        // The direct base `B`.
+        template <typename B> requires(kind == detail::Kind::structure || (kind == detail::Kind::bulk && classify_opt<T> == Category::structure))
+        [[nodiscard]] View<B> GetBase() const
+        {
+            constexpr int index = []<int ...K>(std::integer_sequence<int, K...>){
+                int ret = -1;
+                ((std::is_same_v<typename detail::ChildType<T, K>::type, B> ? void(ret = K) : void()), ...);
+                return ret;
+            }(std::make_integer_sequence<int, detail::num_bases<T>>{});
+            static_assert(index != -1, "`B` isn't a direct non-virtual base of `T`.");
+            if constexpr (kind == detail::Kind::structure)
+                return View<B>(data + detail::StructLayout<T>::value.offsets[index]);
+            else
+                return View<B>(reinterpret_cast<const unsigned char *>(&Bases::CastToBase<B>(Value())));
+        }
+
+        // --- Ranges:
+
+        class Iterator
+        {
+            const unsigned char *ptr = nullptr;
+
+          public:
+            using value_type = View<detail::RangeElem<T>>;
+            using difference_type = std::ptrdiff_t;
+
+            constexpr Iterator() = default;
+            constexpr explicit Iterator(const unsigned char *ptr) : ptr(ptr) {}
+
+            [[nodiscard]] constexpr value_type operator*() const {return value_type(ptr);}
+            constexpr Iterator &operator++() {ptr += detail::flat_size<detail::RangeElem<T>>; return *this;}
+            constexpr Iterator operator++(int) {Iterator ret = *this; ++*this; return ret;}
+            [[nodiscard]] constexpr bool operator==(const Iterator &) const = default;
+        };
+
+        [[nodiscard]] std::size_t size() const requires(kind == detail::Kind::range)
+        {
+            return std::size_t(Load<RelSpan>().size);
+        }
+        [[nodiscard]] bool empty() const requires(kind == detail::Kind::range)
+        {
+            return size() == 0;
+        }
+
+        [[nodiscard]] auto operator[](std::size_t i) const requires(kind == detail::Kind::range)
+        {
+            return View<detail::RangeElem<T>>(data + Load<RelSpan>().offset + i * detail::flat_size<detail::RangeElem<T>>);
+        }
+
+        [[nodiscard]] Iterator begin() const requires(kind == detail::Kind::range)
+        {
+            return Iterator(data + Load<RelSpan>().offset);
+        }
+        [[nodiscard]] Iterator end() const requires(kind == detail::Kind::range)
+        {
+            const auto span = Load<RelSpan>();
+            return Iterator(data + span.offset + span.size * detail::flat_size<detail::RangeElem<T>>);
+        }
+
+        // The elements as a contiguous array, if they are `BulkCopyable`.
+        [[nodiscard]] auto AsSpan() const requires(kind == detail::Kind::range) && (detail::kind<detail::RangeElem<T>> == detail::Kind::bulk)
+        {
+            const auto span = Load<RelSpan>();
+            return std::span<const detail::RangeElem<T>>(std::launder(reinterpret_cast<const detail::RangeElem<T> *>(data + span.offset)), std::size_t(span.size));
+        }
+
+        // The elements as a string view, if they are characters.
+        [[nodiscard]] auto AsStringView() const requires(kind == detail::Kind::range) && detail::is_char_type<detail::RangeElem<T>>
+        {
+            const auto span = AsSpan();
+            return std::basic_string_view<detail::RangeElem<T>>(span.data(), span.size());
+        }
+
+        // --- Indirect types:
+
+        // Returns false if this is null. Always returns true for the types that can't be null.
+        [[nodiscard]] bool HasValue() const requires(kind == detail::Kind::nullable || kind == detail::Kind::inline_indirect)
+        {
+            if constexpr (kind == detail::Kind::nullable)
+                return Load<RelPtr>().offset != 0;
+            else
+                return true;
+        }
+
+        // The target. If this is null, the behavior is undefined.
+        [[nodiscard]] auto Value() const requires(kind == detail::Kind::nullable || kind == detail::Kind::inline_indirect)
+        {
+            if constexpr (kind == detail::Kind::nullable)
+                return View<detail::IndirectElem<T>>(data + Load<RelPtr>().offset);
+            else
+                return View<detail::IndirectElem<T>>(data);
+        }
+
+        // --- Variants:
+
+        [[nodiscard]] std::size_t index() const requires(kind == detail::Kind::variant)
+        {
+            return std::size_t(Load<RelVariant>().index);
+        }
+
+        // The `I`th alternative. Throws if it's not the active one.
+        template <std::size_t I> requires(kind == detail::Kind::variant) && (I < std::variant_size_v<T>)
+        [[nodiscard]] View<std::remove_cv_t<std::variant_alternative_t<I, T>>> Get() const
+        {
+            const auto var = Load<RelVariant>();
+            if (var.index != I)
+                throw std::runtime_error(fmt::format("Flat view: requested variant alternative {}, but the active one is {}.", I, var.index));
+            return View<std::remove_cv_t<std::variant_alternative_t<I, T>>>(data + var.offset);
+        }
+    };
+}
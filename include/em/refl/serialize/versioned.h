@@ -0,0 +1,697 @@
+#pragma once
+
+#include "em/meta/common.h"
+#include "em/meta/const_for.h"
+#include "em/meta/type_name.h"
+#include "em/refl/classify.h"
+#include "em/refl/common.h"
+#include "em/refl/fingerprint.h"
+#include "em/refl/macros/structs.h"
+#include "em/refl/serialize/binary.h"
+#include "em/refl/visit_members.h"
+#include "em/refl/visit_types.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept> // IWYU pragma: keep, clearly used below.
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Versioned serialization, which can load the data saved with older (or newer) versions of the types.
+// The format is: the `schema_fingerprint` of the type (see `em/refl/fingerprint.h`), the size of the schema in bytes, the schema itself,
+//   and then the object serialized with `em/refl/serialize/binary.h`. Everything is in the native byte order.
+//
+// When loading, if the stored fingerprint matches the type, the schema is skipped and the object is read with `Binary::Read()` directly.
+// Otherwise the data is converted using the stored schema, which still reads the unchanged subtrees directly, since the schema stores their fingerprints too.
+// The conversion rules are:
+// * The struct members are matched by name, or by position for the unnamed ones (such as in `std::pair`).
+//   The stored members that don't exist anymore are skipped, and the new members keep their current values.
+// * The bases are matched by position among the bases. It's an error if a stored base doesn't exist anymore.
+// * The scalars can be converted between any arithmetic types and enums, with the usual C++ conversions.
+//   It's an error if a floating-point value doesn't fit in the target type, since that conversion would be UB.
+// * Ranges can change the container type. Fixed-size ranges and arrays receive as many elements as fit, the rest are skipped.
+// * Variant alternatives are matched by position, and it's an error if the stored alternative doesn't exist anymore.
+// * Otherwise the kinds must match (e.g. a struct can't be converted to a range), or an exception is thrown.
+
+namespace em::Refl::Versioned
+{
+    struct SchemaChild
+    {
+        EM_REFL(
+            (std::string)(name) // The member name. Empty for everything else.
+            (bool)(is_base) // Whether this is a base of a struct.
+            (std::uint32_t)(node) // The index in `Schema::nodes`.
+        )
+    };
+
+    struct SchemaNode
+    {
+        EM_REFL(
+            (SchemaKind)(kind)
+            (std::uint64_t)(size) // The size of a scalar in bytes, or the number of elements in an array. Zero otherwise.
+            (std::uint64_t)(fingerprint) // The `schema_fingerprint` of this type.
+            (std::vector<SchemaChild>)(children) // The struct subobjects in the `VisitTypes()` order, the variant alternatives, or the single element type.
+        )
+    };
+
+    // Describes the serialized representation of a type. The types are deduplicated, so this can describe recursive types.
+    struct Schema
+    {
+        EM_REFL(
+            (std::vector<SchemaNode>)(nodes) // The first one is the root.
+        )
+    };
+
+    namespace detail
+    {
+        template <typename T, VisitMode Mode>
+        constexpr char type_tag = 0;
+
+        class SchemaBuilder
+        {
+            // Identifies the types of `schema.nodes`, to deduplicate them.
+            std::vector<const void *> tags;
+
+          public:
+            Schema schema;
+
+            // Returns the index of the node describing `T`, adding it if it's not there yet.
+            template <typename T, VisitMode Mode>
+            std::uint32_t AddNode()
+            {
+                using U = typename Refl::detail::Fingerprint::Canonical<T>::type;
+                constexpr SchemaKind kind = Refl::detail::Fingerprint::GetKind<U>();
+
+                const void *tag = &type_tag<U, kind == SchemaKind::structure ? Mode : VisitMode::normal>;
+                if (auto it = std::ranges::find(tags, tag); it != tags.end())
+                    return std::uint32_t(it - tags.begin());
+
+                const auto index = std::uint32_t(schema.nodes.size());
+                tags.push_back(tag);
+                schema.nodes.push_back({.kind = kind, .fingerprint = schema_fingerprint<U, Mode>});
+
+                // Not holding a reference to the node here, since adding the children can reallocate the vector.
+                std::vector<SchemaChild> children;
+                std::uint64_t size = 0;
+                if constexpr (kind == SchemaKind::array)
+                {
+                    size = std::extent_v<U>;
+                    children.push_back({.node = AddNode<std::remove_extent_t<U>, VisitMode::normal>()});
+                }
+                else if constexpr (kind == SchemaKind::structure)
+                {
+                    (VisitTypes<U, Meta::LoopSimple, Mode>)([&]<typename SubT, VisitDesc Desc>
+                    {
+                        children.push_back({
+                            .name = std::string(Refl::detail::Fingerprint::ChildName<Desc>()),
+                            .is_base = std::derived_from<Desc, VisitingAnyBase>,
+                            .node = AddNode<SubT, Desc::mode>(),
+                        });
+                    });
+                }
+                else if constexpr (kind == SchemaKind::range || kind == SchemaKind::nullable || kind == SchemaKind::variant)
+                {
+                    (VisitTypes<U, Meta::LoopSimple>)([&]<typename SubT, VisitDesc Desc>
+                    {
+                        children.push_back({.node = AddNode<SubT, Desc::mode>()});
+                    });
+                }
+                else
+                {
+                    size = sizeof(U);
+                }
+
+                schema.nodes[index].size = size;
+                schema.nodes[index].children = std::move(children);
+                return index;
+            }
+        };
+
+        [[nodiscard]] constexpr bool IsScalarKind(SchemaKind kind)
+        {
+            return kind == SchemaKind::signed_int || kind == SchemaKind::unsigned_int || kind == SchemaKind::floating || kind == SchemaKind::boolean;
+        }
+
+        // Structs and arrays don't consume any input by themselves.
+        [[nodiscard]] constexpr bool IsTransparentKind(SchemaKind kind)
+        {
+            return kind == SchemaKind::structure || kind == SchemaKind::array;
+        }
+
+        [[nodiscard]] constexpr std::uint64_t SaturatingAdd(std::uint64_t a, std::uint64_t b)
+        {
+            return a > std::numeric_limits<std::uint64_t>::max() - b ? std::numeric_limits<std::uint64_t>::max() : a + b;
+        }
+
+        [[nodiscard]] constexpr std::uint64_t SaturatingMul(std::uint64_t a, std::uint64_t b)
+        {
+            return b != 0 && a > std::numeric_limits<std::uint64_t>::max() / b ? std::numeric_limits<std::uint64_t>::max() : a * b;
+        }
+
+        // Throws if the schema is malformed. The rest of the code relies on this.
+        // Returns the smallest number of input bytes an object of each node can take, which we use to reject the range sizes that can't fit in the input.
+        [[nodiscard]] inline std::vector<std::uint64_t> ValidateSchema(const Schema &schema)
+        {
+            if (schema.nodes.empty())
+                throw std::runtime_error("Versioned deserialization: the schema is empty.");
+
+            // How many transparent nodes refer to each node.
+            std::vector<std::uint32_t> num_parents(schema.nodes.size());
+
+            for (std::size_t i = 0; i < schema.nodes.size(); i++)
+            {
+                const SchemaNode &node = schema.nodes[i];
+
+                bool valid = false;
+                switch (node.kind)
+                {
+                  case SchemaKind::signed_int:
+                  case SchemaKind::unsigned_int:
+                  case SchemaKind::floating:
+                  case SchemaKind::boolean:
+                    valid = node.size > 0 && node.children.empty();
+                    break;
+                  case SchemaKind::array:
+                  case SchemaKind::range:
+                  case SchemaKind::nullable:
+                    valid = node.children.size() == 1;
+                    break;
+                  case SchemaKind::structure:
+                  case SchemaKind::variant:
+                    valid = true;
+                    break;
+                  case SchemaKind::recursive:
+                    break;
+                }
+                if (!valid)
+                    throw std::runtime_error(fmt::format("Versioned deserialization: schema node {} is invalid.", i));
+
+                for (const SchemaChild &child : node.children)
+                {
+                    if (child.node >= schema.nodes.size())
+                        throw std::runtime_error(fmt::format("Versioned deserialization: schema node {} refers to a nonexistent node {}.", i, child.node));
+                    if (IsTransparentKind(node.kind))
+                        num_parents[child.node]++;
+                }
+            }
+
+            // Check that there are no cycles going through only the transparent nodes, otherwise `Skip()` could loop forever.
+            // `order` receives the nodes with the transparent parents before their children.
+            std::vector<std::uint32_t> order;
+            std::vector<std::uint32_t> queue;
+            for (std::size_t i = 0; i < schema.nodes.size(); i++)
+            {
+                if (num_parents[i] == 0)
+                    queue.push_back(std::uint32_t(i));
+            }
+            while (!queue.empty())
+            {
+                const SchemaNode &node = schema.nodes[queue.back()];
+                order.push_back(queue.back());
+                queue.pop_back();
+                if (IsTransparentKind(node.kind))
+                {
+                    for (const SchemaChild &child : node.children)
+                    {
+                        if (--num_parents[child.node] == 0)
+                            queue.push_back(child.node);
+                    }
+                }
+            }
+            if (order.size() != schema.nodes.size())
+                throw std::runtime_error("Versioned deserialization: the schema has a struct that contains itself.");
+
+            // Visit the children of the transparent nodes first, their sizes add up.
+            std::vector<std::uint64_t> min_sizes(schema.nodes.size());
+            for (std::uint32_t i : order | std::views::reverse)
+            {
+                const SchemaNode &node = schema.nodes[i];
+                switch (node.kind)
+                {
+                  case SchemaKind::array:
+                    min_sizes[i] = SaturatingMul(min_sizes[node.children[0].node], node.size);
+                    break;
+                  case SchemaKind::structure:
+                    for (const SchemaChild &child : node.children)
+                        min_sizes[i] = SaturatingAdd(min_sizes[i], min_sizes[child.node]);
+                    break;
+                  case SchemaKind::range:
+                    min_sizes[i] = sizeof(std::uint64_t);
+                    break;
+                  case SchemaKind::nullable:
+                    min_sizes[i] = sizeof(unsigned char);
+                    break;
+                  case SchemaKind::variant:
+                    min_sizes[i] = sizeof(std::uint32_t);
+                    break;
+                  default:
+                    min_sizes[i] = node.size; // A scalar.
+                    break;
+                }
+            }
+            return min_sizes;
+        }
+
+        struct Context
+        {
+            const Schema &schema;
+            const std::vector<std::uint64_t> &min_sizes; // See `ValidateSchema()`.
+            Binary::SpanInput input;
+
+            template <typename S>
+            [[nodiscard]] S Read()
+            {
+                S ret{};
+                input(&ret, sizeof(S));
+                return ret;
+            }
+
+            void SkipBytes(std::uint64_t size)
+            {
+                if (size > input.bytes.size())
+                    throw std::runtime_error(fmt::format("Versioned deserialization: unexpected end of input, need {} more bytes but only {} remain.", size, input.bytes.size()));
+                input.bytes = input.bytes.subspan(std::size_t(size));
+            }
+
+            // Throws if `size` objects described by `node_index` can't fit in the rest of the input.
+            // The objects that take no input are counted as one byte, so their number is bounded too.
+            void CheckRangeSize(std::uint32_t node_index, std::uint64_t size) const
+            {
+                const std::uint64_t elem_size = std::max(min_sizes[node_index], std::uint64_t(1));
+                if (size > input.bytes.size() / elem_size)
+                    throw std::runtime_error(fmt::format("Versioned deserialization: range size {} can't fit in the remaining {} bytes.", size, input.bytes.size()));
+            }
+        };
+
+        inline void Skip(Context &ctx, std::uint32_t node_index);
+
+        // Skips `count` objects described by `node_index`.
+        inline void SkipRepeated(Context &ctx, std::uint32_t node_index, std::uint64_t count)
+        {
+            for (std::uint64_t i = 0; i < count; i++)
+            {
+                const std::size_t old_size = ctx.input.bytes.size();
+                Skip(ctx, node_index);
+                // If the first object is empty, the rest are empty too. This stops us from looping for a long time on large sizes.
+                if (ctx.input.bytes.size() == old_size)
+                    break;
+            }
+        }
+
+        // Skips an object described by `node_index`, without deserializing it.
+        inline void Skip(Context &ctx, std::uint32_t node_index)
+        {
+            const SchemaNode &node = ctx.schema.nodes[node_index];
+
+            switch (node.kind)
+            {
+              case SchemaKind::signed_int:
+              case SchemaKind::unsigned_int:
+              case SchemaKind::floating:
+              case SchemaKind::boolean:
+                ctx.SkipBytes(node.size);
+                break;
+              case SchemaKind::array:
+                SkipRepeated(ctx, node.children[0].node, node.size);
+                break;
+              case SchemaKind::structure:
+                for (const SchemaChild &child : node.children)
+                    Skip(ctx, child.node);
+                break;
+              case SchemaKind::range:
+                SkipRepeated(ctx, node.children[0].node, ctx.Read<std::uint64_t>());
+                break;
+              case SchemaKind::nullable:
+                if (ctx.Read<unsigned char>())
+                    Skip(ctx, node.children[0].node);
+                break;
+              case SchemaKind::variant:
+                {
+                    const auto index = ctx.Read<std::uint32_t>();
+                    if (index >= node.children.size())
+                        throw std::runtime_error(fmt::format("Versioned deserialization: variant index {} is out of range.", index));
+                    Skip(ctx, node.children[index].node);
+                }
+                break;
+              case SchemaKind::recursive:
+                // `ValidateSchema()` rejects those.
+                break;
+            }
+        }
+
+        // Reads a scalar of the first type in `S...` that has this `size`, and passes it to `func`. Returns false if there's no such type.
+        template <typename ...S, typename F>
+        [[nodiscard]] bool ReadScalarOfSize(Context &ctx, std::uint64_t size, F &&func)
+        {
+            return ((size == sizeof(S) && (func(ctx.Read<S>()), true)) || ...);
+        }
+
+        // Whether converting `source` to `T` is well-defined. Only the conversions from floating-point types can be out of range.
+        template <typename T, typename S>
+        [[nodiscard]] bool ScalarFits(S source)
+        {
+            if constexpr (!std::is_floating_point_v<S> || std::is_same_v<T, bool>)
+            {
+                (void)source;
+                return true;
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                // The truncated value must be in range. The bounds are powers of two, so they are exact. This also rejects NaN.
+                constexpr S upper = S(2) * S(std::uint64_t(1) << (std::numeric_limits<T>::digits - 1));
+                // `-upper - 1` can round to `-upper`, hence the first check.
+                if constexpr (std::is_signed_v<T>)
+                    return (source >= -upper || source > -upper - S(1)) && source < upper;
+                else
+                    return source > S(-1) && source < upper;
+            }
+            else if constexpr (std::numeric_limits<T>::max_exponent >= std::numeric_limits<S>::max_exponent)
+            {
+                (void)source;
+                return true;
+            }
+            else
+            {
+                // Infinities and NaN are fine, they exist in every type we support.
+                return source != source || source == std::numeric_limits<S>::infinity() || source == -std::numeric_limits<S>::infinity() ||
+                    (source >= -S(std::numeric_limits<T>::max()) && source <= S(std::numeric_limits<T>::max()));
+            }
+        }
+
+        template <typename T>
+        void ConvertScalar(Context &ctx, const SchemaNode &node, T &value)
+        {
+            auto assign = [&](auto source)
+            {
+                using Target = typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>, std::type_identity<T>>::type;
+                if (!ScalarFits<Target>(source))
+                    throw std::runtime_error(fmt::format("Versioned deserialization: the stored value {} doesn't fit in `{}`.", source, Meta::TypeName<T>()));
+                value = T(Target(source));
+            };
+
+            bool ok = false;
+            switch (node.kind)
+            {
+              case SchemaKind::signed_int:
+                ok = ReadScalarOfSize<std::int8_t, std::int16_t, std::int32_t, std::int64_t>(ctx, node.size, assign);
+                break;
+              case SchemaKind::unsigned_int:
+                ok = ReadScalarOfSize<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t>(ctx, node.size, assign);
+                break;
+              case SchemaKind::floating:
+                ok = ReadScalarOfSize<float, double, long double>(ctx, node.size, assign);
+                break;
+              case SchemaKind::boolean:
+                // Not reading `bool` directly, since not every byte value is a valid `bool`.
+                ok = ReadScalarOfSize<unsigned char>(ctx, node.size, [&](unsigned char source){assign(source != 0);});
+                break;
+              default:
+                throw std::runtime_error(fmt::format("Versioned deserialization: can't convert a non-scalar to `{}`.", Meta::TypeName<T>()));
+            }
+            if (!ok)
+                throw std::runtime_error(fmt::format("Versioned deserialization: unsupported scalar size {}.", node.size));
+        }
+
+        template <VisitMode Mode = VisitMode::normal, Meta::Deduce..., typename T>
+        void ConvertLow(Context &ctx, std::uint32_t node_index, T &value);
+
+        // Converts the subobject `SubT` of a struct, described by `Desc` (as given by `VisitTypes()`).
+        template <typename T, typename SubT, typename Desc>
+        void ConvertStructChild(Context &ctx, std::uint32_t node_index, void *object)
+        {
+            T &value = *static_cast<T *>(object);
+            if constexpr (std::derived_from<Desc, VisitingAnyBase>)
+                (ConvertLow<Desc::mode>)(ctx, node_index, Bases::CastToBase<std::remove_cvref_t<SubT>>(value));
+            else
+                (ConvertLow<Desc::mode>)(ctx, node_index, Structs::GetMemberMutable<Desc::value>(value));
+        }
+
+        struct StructChild
+        {
+            std::string_view name;
+            bool is_base = false;
+            void (*convert)(Context &ctx, std::uint32_t node_index, void *object) = nullptr;
+        };
+
+        // For every subobject of a struct, its name and a function that converts it.
+        template <typename T, VisitMode Mode>
+        constexpr auto struct_children = []{
+            constexpr int n = []{
+                int ret = 0;
+                (VisitTypes<T, Meta::LoopSimple, Mode>)([&]<typename SubT, VisitDesc Desc>{ret++;});
+                return ret;
+            }();
+
+            std::array<StructChild, n> ret{};
+            int i = 0;
+            (VisitTypes<T, Meta::LoopSimple, Mode>)([&]<typename SubT, VisitDesc Desc>
+            {
+                ret[i++] = {
+                    .name = Refl::detail::Fingerprint::ChildName<Desc>(),
+                    .is_base = std::derived_from<Desc, VisitingAnyBase>,
+                    .convert = ConvertStructChild<T, SubT, Desc>,
+                };
+            });
+            return ret;
+        }();
+
+        template <VisitMode Mode, Meta::Deduce..., typename T>
+        void ConvertLow(Context &ctx, std::uint32_t node_index, T &value)
+        {
+            static_assert(!std::is_const_v<T>, "Can't deserialize into a const object.");
+
+            const SchemaNode &node = ctx.schema.nodes[node_index];
+
+            // If nothing changed in this subtree, read it directly.
+            if (node.fingerprint == schema_fingerprint<T, Mode>)
+            {
+                (Binary::detail::ReadLow<Mode>)(ctx.input, value);
+                return;
+            }
+
+            constexpr Category c = classify_opt<T>;
+
+            if constexpr (c == Category::adjust)
+            {
+                static_assert(std::is_lvalue_reference_v<Adjust::AdjustedType<T &>>, "Can only deserialize the adjusted types that are lvalue references.");
+                (ConvertLow<Mode>)(ctx, node_index, Adjust::Adjust(value));
+            }
+            else if constexpr (c == Category::indirect && Indirect::AlwaysHasValue<T>)
+            {
+                static_assert(std::is_lvalue_reference_v<Indirect::ValueTypeCvref<T &>>, "Can only deserialize the indirect types that return lvalue references.");
+                (ConvertLow<Mode>)(ctx, node_index, Indirect::GetValue(value));
+            }
+            else
+            {
+                constexpr SchemaKind kind = Refl::detail::Fingerprint::GetKind<T>();
+
+                if constexpr (IsScalarKind(kind))
+                {
+                    ConvertScalar(ctx, node, value);
+                }
+                else
+                {
+                    if (node.kind != kind)
+                        throw std::runtime_error(fmt::format("Versioned deserialization: the stored data has a different kind, can't convert it to `{}`.", Meta::TypeName<T>()));
+
+                    if constexpr (kind == SchemaKind::array)
+                    {
+                        const std::uint32_t elem_node = node.children[0].node;
+                        const std::uint64_t n = std::min(node.size, std::uint64_t(std::extent_v<T>));
+                        for (std::uint64_t i = 0; i < n; i++)
+                            (ConvertLow)(ctx, elem_node, value[i]);
+                        SkipRepeated(ctx, elem_node, node.size - n);
+                    }
+                    else if constexpr (kind == SchemaKind::structure)
+                    {
+                        constexpr auto &children = struct_children<T, Mode>;
+                        // Returns the `index`th child that is (or isn't) a base, or `children.end()` if there's no such child.
+                        auto nth_child = [&](bool is_base, std::size_t index)
+                        {
+                            auto it = children.begin();
+                            for (; it != children.end(); ++it)
+                            {
+                                if (it->is_base == is_base && index-- == 0)
+                                    break;
+                            }
+                            return it;
+                        };
+
+                        std::size_t num_bases = 0;
+                        for (std::size_t i = 0; i < node.children.size(); i++)
+                        {
+                            const SchemaChild &stored = node.children[i];
+                            auto it = children.end();
+                            if (stored.is_base)
+                            {
+                                it = nth_child(true, num_bases++);
+                                if (it == children.end())
+                                    throw std::runtime_error(fmt::format("Versioned deserialization: the stored data has base {}, but `{}` has fewer bases.", num_bases - 1, Meta::TypeName<T>()));
+                            }
+                            else if (!stored.name.empty())
+                            {
+                                it = std::ranges::find(children, std::string_view(stored.name), &StructChild::name);
+                            }
+                            else
+                            {
+                                // An unnamed member, match it by position among the members.
+                                it = nth_child(false, i - num_bases);
+                                if (it != children.end() && !it->name.empty())
+                                    it = children.end();
+                            }
+
+                            if (it != children.end())
+                                it->convert(ctx, stored.node, &value);
+                            else
+                                Skip(ctx, stored.node);
+                        }
+                    }
+                    else if constexpr (kind == SchemaKind::range)
+                    {
+                        using Elem = typename Binary::detail::InsertableElementType<T>::type;
+
+                        const std::uint32_t elem_node = node.children[0].node;
+                        const auto size = ctx.Read<std::uint64_t>();
+
+                        if constexpr (requires{value.resize(std::size_t(size));})
+                        {
+                            ctx.CheckRangeSize(elem_node, size);
+                            value.resize(std::size_t(size));
+                            (VisitMembers<Meta::LoopSimple>)(value, [&]<VisitDesc Desc>(auto &elem){(ConvertLow<Desc::mode>)(ctx, elem_node, elem);});
+                        }
+                        else if constexpr (requires(Elem &&elem){value.clear(); value.insert(value.end(), std::move(elem));})
+                        {
+                            ctx.CheckRangeSize(elem_node, size);
+                            value.clear();
+                            for (std::uint64_t i = 0; i < size; i++)
+                            {
+                                Elem elem{};
+                                (ConvertLow)(ctx, elem_node, elem);
+                                value.insert(value.end(), std::move(elem));
+                            }
+                        }
+                        else
+                        {
+                            // A fixed-size range.
+                            std::uint64_t i = 0;
+                            (VisitMembers<Meta::LoopSimple>)(value, [&]<VisitDesc Desc>(auto &elem)
+                            {
+                                if (i++ < size)
+                                    (ConvertLow<Desc::mode>)(ctx, elem_node, elem);
+                            });
+                            if (i < size)
+                                SkipRepeated(ctx, elem_node, size - i);
+                        }
+                    }
+                    else if constexpr (kind == SchemaKind::nullable)
+                    {
+                        static_assert(requires{value.reset(); value.emplace();}, "Can only deserialize nullable indirect types that have `.emplace()` and `.reset()`, such as `std::optional`.");
+                        if (ctx.Read<unsigned char>())
+                        {
+                            value.emplace();
+                            (ConvertLow)(ctx, node.children[0].node, Indirect::GetValue(value));
+                        }
+                        else
+                        {
+                            value.reset();
+                        }
+                    }
+                    else if constexpr (kind == SchemaKind::variant)
+                    {
+                        const auto index = ctx.Read<std::uint32_t>();
+                        if (index >= node.children.size())
+                            throw std::runtime_error(fmt::format("Versioned deserialization: variant index {} is out of range.", index));
+
+                        bool found = Meta::ConstFor<Meta::LoopAnyOf<>, std::variant_size_v<T>>([&]<std::size_t I> -> bool
+                        {
+                            if (index != I)
+                                return false;
+                            value.template emplace<I>();
+                            (ConvertLow)(ctx, node.children[index].node, Variants::Get<I>(value));
+                            return true;
+                        });
+                        if (!found)
+                            throw std::runtime_error(fmt::format("Versioned deserialization: variant alternative {} doesn't exist in `{}`.", index, Meta::TypeName<T>()));
+                    }
+                }
+            }
+        }
+    }
+
+    // Describes the serialized representation of `T`.
+    template <typename T>
+    [[nodiscard]] Schema MakeSchema()
+    {
+        detail::SchemaBuilder builder;
+        (void)builder.AddNode<T, VisitMode::normal>();
+        return std::move(builder.schema);
+    }
+
+    namespace detail
+    {
+        // The schema only depends on the type, so we serialize it once.
+        template <typename T>
+        [[nodiscard]] const std::vector<unsigned char> &SchemaBytes()
+        {
+            static const std::vector<unsigned char> ret = Binary::ToBytes(MakeSchema<T>());
+            return ret;
+        }
+    }
+
+    // Serializes `value` along with its schema.
+    template <Meta::Deduce..., typename T>
+    [[nodiscard]] std::vector<unsigned char> ToBytes(const T &value)
+    {
+        const std::vector<unsigned char> &schema = detail::SchemaBytes<T>();
+
+        std::vector<unsigned char> ret;
+        Binary::VectorOutput output{&ret};
+        const std::uint64_t header[2] = {schema_fingerprint<T>, schema.size()};
+        output(header, sizeof(header));
+        output(schema.data(), schema.size());
+        Binary::Write(value, output);
+        return ret;
+    }
+
+    // Deserializes `value` from `bytes`, produced by `ToBytes()` for this type or some other version of it.
+    // Throws if the input is invalid, if it can't be converted to `T`, or if there are unused bytes at the end.
+    // On failure `value` is left in an unspecified (but valid) state.
+    template <Meta::Deduce..., typename T>
+    void FromBytes(T &value, std::span<const unsigned char> bytes)
+    {
+        Binary::SpanInput input{bytes};
+        std::uint64_t header[2]{};
+        input(header, sizeof(header));
+        if (header[1] > input.bytes.size())
+            throw std::runtime_error(fmt::format("Versioned deserialization: the schema size {} exceeds the remaining {} bytes of input.", header[1], input.bytes.size()));
+        const std::span<const unsigned char> schema_bytes = input.bytes.first(std::size_t(header[1]));
+        input.bytes = input.bytes.subspan(std::size_t(header[1]));
+
+        if (header[0] == schema_fingerprint<T>)
+        {
+            // Nothing changed, don't even look at the schema.
+            Binary::FromBytes(value, input.bytes);
+            return;
+        }
+
+        Schema schema;
+        Binary::FromBytes(schema, schema_bytes);
+        const std::vector<std::uint64_t> min_sizes = detail::ValidateSchema(schema);
+
+        detail::Context ctx{.schema = schema, .min_sizes = min_sizes, .input = input};
+        (detail::ConvertLow)(ctx, 0, value);
+        if (!ctx.input.bytes.empty())
+            throw std::runtime_error(fmt::format("Versioned deserialization: {} unused bytes at the end of input.", ctx.input.bytes.size()));
+    }
+}
@@ -0,0 +1,248 @@
+#pragma once
+
+#include "em/meta/common.h"
+#include "em/meta/const_for.h"
+#include "em/refl/access/bases.h"
+#include "em/refl/access/structs.h"
+#include "em/refl/common.h"
+#include "em/zstring_view.h"
+
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A struct-of-arrays container for `EM_REFL()` structs.
+// `SoaVector<T>` stores every non-static member of `T` in its own contiguous column, so the loops that only need a few members
+//   read only those, with unit stride. Use `Column<I>()` to get the columns as spans.
+// `operator[]` returns a proxy that is itself a reflected struct with the same members (and attributes and names) as `T`,
+//   so `VisitMembers()` and the things built on top of it work on it. It also converts to and from `T`.
+//
+// The elements must be plain structs: no bases, and no const, reference or `bool` members (since `std::vector<bool>` isn't contiguous).
+
+namespace em::Refl
+{
+    template <Structs::Type T>
+    class SoaVector;
+
+    template <typename T, bool IsConst>
+    class SoaVectorRef;
+
+    namespace detail::Soa
+    {
+        template <typename T, typename Seq = std::make_integer_sequence<int, Structs::num_members<T>>>
+        struct Columns {};
+        template <typename T, int ...I>
+        struct Columns<T, std::integer_sequence<int, I...>> {using type = std::tuple<std::vector<Structs::MemberType<T, I>>...>;};
+
+        template <typename T, typename Seq = std::make_integer_sequence<int, Structs::num_members<T>>>
+        constexpr bool valid_member_types = false;
+        template <typename T, int ...I>
+        constexpr bool valid_member_types<T, std::integer_sequence<int, I...>> = (Meta::cvref_unqualified<Structs::MemberType<T, I>> && ...) && (!std::is_same_v<Structs::MemberType<T, I>, bool> && ...);
+
+        // The reflection traits of `SoaVectorRef`. They forward the member info and names from `T`.
+        template <typename T>
+        struct RefTraits
+        {
+            static constexpr int num_members = Structs::num_members<T>;
+
+            // A const proxy only gives const access, like a const `T` would.
+            template <int I>
+            [[nodiscard]] static constexpr auto &GetMember(auto &&self)
+            {
+                auto &elem = self.Vector().template Column<I>()[self.Index()];
+                if constexpr (std::is_const_v<std::remove_reference_t<decltype(self)>>)
+                    return std::as_const(elem);
+                else
+                    return elem;
+            }
+
+            template <int I> requires requires{Structs::detail::NonStaticTraits<T>::template GetMemberInfo<I>();}
+            [[nodiscard]] static constexpr auto GetMemberInfo()
+            {
+                return Structs::detail::NonStaticTraits<T>::template GetMemberInfo<I>();
+            }
+
+            [[nodiscard]] static constexpr zstring_view GetMemberName(int i) requires Structs::HasMemberNames<T>
+            {
+                return Structs::GetMemberName<T>(i);
+            }
+        };
+    }
+
+    // A reference to one element of a `SoaVector`. This is a reflected struct with the same members as `T`.
+    // Like `std::vector<bool>::reference`, assigning to it assigns the element, rather than rebinding the reference.
+    template <typename T, bool IsConst>
+    class SoaVectorRef
+    {
+        using Vec = std::conditional_t<IsConst, const SoaVector<T>, SoaVector<T>>;
+
+        Vec *vec = nullptr;
+        std::size_t index = 0;
+
+      public:
+        constexpr SoaVectorRef(Vec &vec, std::size_t index) : vec(&vec), index(index) {}
+
+        constexpr SoaVectorRef(const SoaVectorRef &) = default;
+
+        // Mutable to const conversion.
+        constexpr SoaVectorRef(const SoaVectorRef<T, false> &other) requires IsConst
+            : vec(&other.Vector()), index(other.Index())
+        {}
+
+        [[nodiscard]] constexpr Vec &Vector() const {return *vec;}
+        [[nodiscard]] constexpr std::size_t Index() const {return index;}
+
+        // Gathers the element from the columns.
+        [[nodiscard]] constexpr operator T() const
+        {
+            T ret{};
+            Meta::ConstFor<Meta::LoopSimple, Structs::num_members<T>>([&]<int I>
+            {
+                Structs::GetMemberMutable<I>(ret) = vec->template Column<I>()[index];
+            });
+            return ret;
+        }
+
+        // Scatters `value` to the columns.
+        constexpr const SoaVectorRef &operator=(const T &value) const requires(!IsConst)
+        {
+            Meta::ConstFor<Meta::LoopSimple, Structs::num_members<T>>([&]<int I>
+            {
+                vec->template Column<I>()[index] = Structs::GetMemberConst<I>(value);
+            });
+            return *this;
+        }
+
+        constexpr const SoaVectorRef &operator=(const SoaVectorRef &other) const requires(!IsConst)
+        {
+            Meta::ConstFor<Meta::LoopSimple, Structs::num_members<T>>([&]<int I>
+            {
+                vec->template Column<I>()[index] = other.vec->template Column<I>()[other.index];
+            });
+            return *this;
+        }
+
+        friend constexpr detail::Soa::RefTraits<T> _adl_em_refl_StructFallbackNonStatic(int/*AdlDummy*/, const SoaVectorRef *) {return {};}
+    };
+
+    template <Structs::Type T>
+    class SoaVector
+    {
+        static_assert(Meta::cvref_unqualified<T>, "The element type must not be cvref-qualified.");
+        static_assert(!Bases::HasBases<T>, "The element type must not have bases.");
+        static_assert(detail::Soa::valid_member_types<T>, "The members must not be const, references, or `bool`.");
+
+        typename detail::Soa::Columns<T>::type columns;
+        std::size_t num_elems = 0;
+
+        // Calls `func.template operator()<I>()` for every column index.
+        template <typename F>
+        static constexpr void ForEachColumn(F &&func)
+        {
+            Meta::ConstFor<Meta::LoopSimple, Structs::num_members<T>>([&]<int I>{func.template operator()<I>();});
+        }
+
+        // Appends one element, `get.template operator()<I>()` returns the value for the `I`th column.
+        // If this throws, the columns are left unchanged.
+        template <typename F>
+        constexpr void AppendLow(F &&get)
+        {
+            int num_appended = 0;
+            try
+            {
+                ForEachColumn([&]<int I>
+                {
+                    std::get<I>(columns).push_back(get.template operator()<I>());
+                    num_appended++;
+                });
+            }
+            catch (...)
+            {
+                ForEachColumn([&]<int I>
+                {
+                    if (I < num_appended)
+                        std::get<I>(columns).pop_back();
+                });
+                throw;
+            }
+            num_elems++;
+        }
+
+      public:
+        using value_type = T;
+        using reference = SoaVectorRef<T, false>;
+        using const_reference = SoaVectorRef<T, true>;
+
+        static constexpr int num_columns = Structs::num_members<T>;
+
+        constexpr SoaVector() = default;
+
+        [[nodiscard]] constexpr std::size_t size() const {return num_elems;}
+        [[nodiscard]] constexpr bool empty() const {return num_elems == 0;}
+
+        constexpr void reserve(std::size_t n)
+        {
+            ForEachColumn([&]<int I>{std::get<I>(columns).reserve(n);});
+        }
+
+        // If this throws, the size is left unchanged.
+        constexpr void resize(std::size_t n)
+        {
+            try
+            {
+                ForEachColumn([&]<int I>{std::get<I>(columns).resize(n);});
+            }
+            catch (...)
+            {
+                // Shrinking doesn't throw.
+                ForEachColumn([&]<int I>
+                {
+                    if (std::get<I>(columns).size() > num_elems)
+                        std::get<I>(columns).resize(num_elems);
+                });
+                throw;
+            }
+            num_elems = n;
+        }
+
+        constexpr void clear()
+        {
+            ForEachColumn([&]<int I>{std::get<I>(columns).clear();});
+            num_elems = 0;
+        }
+
+        constexpr void push_back(const T &value)
+        {
+            AppendLow([&]<int I> -> decltype(auto) {return Structs::GetMemberConst<I>(value);});
+        }
+
+        constexpr void push_back(T &&value)
+        {
+            AppendLow([&]<int I> -> decltype(auto) {return std::move(Structs::GetMemberMutable<I>(value));});
+        }
+
+        constexpr void pop_back()
+        {
+            ForEachColumn([&]<int I>{std::get<I>(columns).pop_back();});
+            num_elems--;
+        }
+
+        [[nodiscard]] constexpr reference operator[](std::size_t i) {return {*this, i};}
+        [[nodiscard]] constexpr const_reference operator[](std::size_t i) const {return {*this, i};}
+
+        // Returns the `I`th member of all elements, as a contiguous array.
+        template <int I> requires Structs::ValidMemberIndex<T, I>
+        [[nodiscard]] constexpr std::span<Structs::MemberType<T, I>> Column()
+        {
+            return std::get<I>(columns);
+        }
+        template <int I> requires Structs::ValidMemberIndex<T, I>
+        [[nodiscard]] constexpr std::span<const Structs::MemberType<T, I>> Column() const
+        {
+            return std::get<I>(columns);
+        }
+    };
+}
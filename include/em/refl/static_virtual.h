@@ -1,19 +1,21 @@
 #pragma once
 
-#include "em/macros/meta/common.h"
-#include "em/macros/portable/warnings.h"
 #include "em/meta/type_name.h"
-#include "em/refl/macros/structs.h"
+#include "em/refl/macros/static_virtual.h" // IWYU pragma: export
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <functional>
 #include <map>
+#include <span>
 #include <stdexcept> // IWYU pragma: keep, clearly used below.
 #include <string>
+#include <string_view>
+#include <vector>
 
 
-// Provides the `EM_STATIC_VIRTUAL()` macro, see below.
+// The registry behind the `EM_STATIC_VIRTUAL()` macro. The macro itself is in `em/refl/macros/static_virtual.h`, see there for the usage.
 
 namespace em::Refl::StaticVirtual
 {
@@ -27,6 +29,77 @@ namespace em::Refl::StaticVirtual
     template <Interface I>
     using Map = std::map<std::string, const I *, std::less<>>;
 
+    // A read-only copy of `Map<I>`, stored contiguously and sorted by name. Obtain this from `GetFrozenMap()`.
+    // The lookups are binary searches over a flat array, which is friendlier to the cache than `Map<I>`.
+    // Each entry also gets a dense integer ID, which is its index in the sorted array.
+    //   The IDs only depend on the set of registered class names, so they are suitable for sending between processes built from the same code.
+    template <Interface I>
+    class FrozenMap
+    {
+      public:
+        struct Entry
+        {
+            std::string_view name; // Points into the original `Map<I>`, which is never modified after freezing.
+            const I *impl = nullptr;
+        };
+
+      private:
+        std::vector<Entry> entries;
+
+      public:
+        explicit FrozenMap(const Map<I> &map)
+        {
+            // The map is already sorted, so we don't need to sort again.
+            entries.reserve(map.size());
+            for (const auto &[name, impl] : map)
+                entries.push_back({name, impl});
+        }
+
+        // All entries, sorted by name.
+        [[nodiscard]] std::span<const Entry> Entries() const {return entries;}
+        [[nodiscard]] auto begin() const {return entries.begin();}
+        [[nodiscard]] auto end() const {return entries.end();}
+        [[nodiscard]] std::size_t size() const {return entries.size();}
+
+        // Returns the ID of the derived class called `name`, or -1 if none.
+        [[nodiscard]] int FindId(std::string_view name) const
+        {
+            auto it = std::ranges::lower_bound(entries, name, std::less<>{}, &Entry::name);
+            if (it == entries.end() || it->name != name)
+                return -1;
+            return int(it - entries.begin());
+        }
+
+        // Returns the implementation for the derived class called `name`, or null if none.
+        [[nodiscard]] const I *Find(std::string_view name) const
+        {
+            int id = FindId(name);
+            return id < 0 ? nullptr : entries[std::size_t(id)].impl;
+        }
+
+        // Returns the implementation for an ID, or null if the ID is out of range.
+        [[nodiscard]] const I *FindById(int id) const
+        {
+            return id >= 0 && std::size_t(id) < entries.size() ? entries[std::size_t(id)].impl : nullptr;
+        }
+
+        // Same as `Find()`, but throws if not found.
+        [[nodiscard]] const I &At(std::string_view name) const
+        {
+            if (const I *ret = Find(name))
+                return *ret;
+            throw std::runtime_error(fmt::format("No derived class named `{}` is registered for this interface.", name));
+        }
+
+        // Same as `FindById()`, but throws if the ID is out of range.
+        [[nodiscard]] const I &AtId(int id) const
+        {
+            if (const I *ret = FindById(id))
+                return *ret;
+            throw std::runtime_error(fmt::format("Derived class ID {} is out of range, only {} classes are registered for this interface.", id, entries.size()));
+        }
+    };
+
     namespace detail
     {
         template <Interface I>
@@ -36,10 +109,20 @@ namespace em::Refl::StaticVirtual
             return ret;
         }
 
+        // Set to true when `GetFrozenMap()` is first called, after which no more classes can be registered.
+        template <Interface I>
+        [[nodiscard]] bool &GetIsFrozen()
+        {
+            static bool ret = false;
+            return ret;
+        }
+
         template <Interface I, typename D, typename DI>
         void RegisterDerived()
         {
             static const DI impl{};
+            if (GetIsFrozen<I>())
+                throw std::runtime_error(fmt::format("Internal error: Derived class registered after the map was frozen: {}", em::Meta::TypeName<D>()));
             if (!GetDerivedMap<I>().try_emplace(std::string(em::Meta::TypeName<D>()), &impl).second)
                 throw std::runtime_error(fmt::format("Internal error: Duplicate derived class registered: {}", em::Meta::TypeName<D>()));
         }
@@ -51,70 +134,30 @@ namespace em::Refl::StaticVirtual
     {
         return detail::GetDerivedMap<I>();
     }
-}
 
-// Type-erases arbitrary information about every class derived from this that has `EM_REFL()` in it (including this class itself),
-//   if it satisfies the condition you specified.
-// Use `em::Refl::StaticVirtual::GetMap()` to then get the list of those classes and the interface implementations for them.
-//
-// Usage, inside of `EM_REFL(...)` of the base class:
-//     EM_STATIC_VIRTUAL(InterfaceName, cond...)
-//     (
-//         func1
-//         func2
-//         ...
-//     )
-//
-// Where:
-//   `InterfaceName` is a class name for an interface that will be created at this location.
-//   `cond...` is a condition, without parentheses, in terms of `_em_Self` and `_em_Derived`, that checks the inheritance.
-//     Typically this would be either `std::derived_from<_em_Derived, _em_Self>` or `std::is_base_of<_em_Self, _em_Derived>`. Not checking either of those
-//       will cause weird behavior, where stray non-derived classes will appear in the lists.
-//     Here `_em_Self` is always the same as the enclosing class, and you can use that class name explicitly if you prefer.
-//     You can add some additional checks here, like rejecting abstract classes.
-//     You might also want to reject `std::is_same_v<_em_Self, _em_Derived>`, since otherwise this class itself will be registered too.
-//
-// And where each `func` is:
-//     (name, (params...) -> ret)
-//     (
-//         body...
-//     )
-// Where:
-//   `name` is the function name.
-//   `(params...)` is a function parameter list, the usual `(type1 name1, type2 name2, ...)`.
-//   `ret` is the return type.
-//   `body...` is the function body. Can contain multiple statements. This is templated over `_em_Derived`, do something with it.
-//
-// Note that this is currently designed to be placed in `EM_REFL()` for no real reason, other than guaranteeing that you can use `_em_Self` in the condition,
-//   which is provided by the reflection.
-#define EM_STATIC_VIRTUAL(interface_name_, .../*cond*/) DETAIL_EM_STATIC_VIRTUAL_3 DETAIL_EM_STATIC_VIRTUAL_1(interface_name_, __VA_ARGS__)
-#define DETAIL_EM_STATIC_VIRTUAL_1(interface_name_, .../*cond*/) (, interface_name_, (__VA_ARGS__ DETAIL_EM_STATIC_VIRTUAL_2
-#define DETAIL_EM_STATIC_VIRTUAL_2(seq_) ), seq_)
-
-#define DETAIL_EM_STATIC_VIRTUAL_3(n, interface_name_, cond_, seq_) \
-    EM_REFL_VERBATIM_LOW(body, em_static_virtual,, \
-        struct interface_name_ \
-        { \
-            using _em_IsStaticVirtuallInterface = void; /* Mark the class so we know it's a valid interface. */\
-            virtual ~interface_name_() = default; \
-            EM_END(DETAIL_EM_REGISTER_DERIVED_BODY_INTERFACE_A seq_) \
-        }; \
-        template <typename _em_Derived> \
-        struct EM_CAT(_em_RegisterDerivedImpl, interface_name_) : interface_name_ \
-        { \
-            EM_END(DETAIL_EM_REGISTER_DERIVED_BODY_IMPL_A seq_) \
-        }; \
-        EM_REFL_INHERITANCE_HOOK(EM_CAT(em_register_derived_, interface_name_), cond_, ::em::Refl::StaticVirtual::detail::RegisterDerived<interface_name_, _em_Derived, EM_CAT(_em_RegisterDerivedImpl, interface_name_)<_em_Derived>>();)\
-    )
-
-#define DETAIL_EM_REGISTER_DERIVED_BODY_INTERFACE_A(name_, ...) EM_SILENCE_UNUSED_ATTRIBUTE( [[nodiscard]] ) virtual auto name_ DETAIL_EM_REGISTER_DERIVED_INJECT_CONST __VA_ARGS__ = 0; DETAIL_EM_REGISTER_DERIVED_BODY_INTERFACE_B
-#define DETAIL_EM_REGISTER_DERIVED_BODY_INTERFACE_B(...) DETAIL_EM_REGISTER_DERIVED_BODY_INTERFACE_A
-#define DETAIL_EM_REGISTER_DERIVED_BODY_INTERFACE_A_END
-#define DETAIL_EM_REGISTER_DERIVED_BODY_INTERFACE_B_END
-
-#define DETAIL_EM_REGISTER_DERIVED_BODY_IMPL_A(name_, ...) EM_SILENCE_UNUSED_ATTRIBUTE( [[nodiscard]] ) auto name_ DETAIL_EM_REGISTER_DERIVED_INJECT_CONST __VA_ARGS__ override DETAIL_EM_REGISTER_DERIVED_BODY_IMPL_B
-#define DETAIL_EM_REGISTER_DERIVED_BODY_IMPL_B(...) {__VA_ARGS__} DETAIL_EM_REGISTER_DERIVED_BODY_IMPL_A
-#define DETAIL_EM_REGISTER_DERIVED_BODY_IMPL_A_END
-#define DETAIL_EM_REGISTER_DERIVED_BODY_IMPL_B_END
-
-#define DETAIL_EM_REGISTER_DERIVED_INJECT_CONST(...) (__VA_ARGS__) const
+    // Same as `GetMap()`, but returns a flat copy of the map, which is faster to search.
+    // The copy is made on the first call. Registering more classes after that is an error, so don't call this during static initialization.
+    template <Interface I>
+    [[nodiscard]] const FrozenMap<I> &GetFrozenMap()
+    {
+        static const FrozenMap<I> ret = []{
+            detail::GetIsFrozen<I>() = true;
+            return FrozenMap<I>(detail::GetDerivedMap<I>());
+        }();
+        return ret;
+    }
+
+    // Returns the dense ID of the derived class `D` in `GetFrozenMap<I>()`. Freezes the map if it's not frozen yet.
+    // Throws if `D` isn't registered for this interface.
+    template <Interface I, typename D>
+    [[nodiscard]] int IdOf()
+    {
+        static const int ret = []{
+            int id = GetFrozenMap<I>().FindId(em::Meta::TypeName<D>());
+            if (id < 0)
+                throw std::runtime_error(fmt::format("Class `{}` isn't registered for this interface.", em::Meta::TypeName<D>()));
+            return id;
+        }();
+        return ret;
+    }
+}
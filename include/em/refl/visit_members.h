@@ -6,10 +6,30 @@
 #include "em/refl/classify.h"
 #include "em/refl/common.h"
 
+#include <cstddef>
 #include <type_traits>
+#include <utility>
 
 namespace em::Refl
 {
+    namespace detail::VariantDispatch
+    {
+        template <typename R, typename T, typename F, std::size_t I>
+        constexpr R VisitAlternative(T &&object, F &func)
+        {
+            return func.template operator()<VisitingVariantAlternative<I>>(Variants::Get<I>(EM_FWD(object)));
+        }
+
+        // A jump table to visit the active alternative of a variant, indexed by `.index()`.
+        template <typename R, typename T, typename F, typename Seq = std::make_index_sequence<std::variant_size_v<std::remove_cvref_t<T>>>>
+        struct JumpTable {};
+        template <typename R, typename T, typename F, std::size_t ...I>
+        struct JumpTable<R, T, F, std::index_sequence<I...>>
+        {
+            static constexpr R (*table[])(T &&, F &) = {&VisitAlternative<R, T, F, I>...};
+        };
+    }
+
     // Calls `func` on every non-static member of `T`, non-recurisvely.
     // `func` is `[]<VisitDesc Desc>(auto &&member)` (or you can add another template parameter for the `member` type).
     // `Desc` receives one of the `Visiting...` tags describing what this member is (defined in `em/refl/common.h`). For most type categories this is `VisitingOther`.
@@ -98,13 +118,14 @@ namespace em::Refl
         }
         else if constexpr (c == Category::variant)
         {
-            return Meta::ConstFor<LoopBackend, std::variant_size_v<std::remove_cvref_t<T>>>(
-                [&]<std::size_t I> -> decltype(auto)
-                {
-                    // Not forwarding the `func` in a loop.
-                    return func.template operator()<VisitingVariantAlternative<I>>(Variants::Get<I>(EM_FWD(object)));
-                }
-            );
+            // Only the active alternative is visited. We read the index once and jump to it through a table,
+            //   so the cost doesn't depend on the number of alternatives.
+            // Like for the indirect types above, `func` must return the same type as `Meta::NoElements()`.
+            using R = decltype(Meta::NoElements<LoopBackend>());
+            const std::size_t index = object.index();
+            if (index >= std::variant_size_v<std::remove_cvref_t<T>>)
+                return Meta::NoElements<LoopBackend>(); // Valueless by exception.
+            return detail::VariantDispatch::JumpTable<R, T, std::remove_reference_t<F>>::table[index](EM_FWD(object), func);
         }
         else if constexpr (c == Category::unknown)
         {
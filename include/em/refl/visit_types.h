@@ -6,7 +6,9 @@
 #include "em/refl/classify.h"
 #include "em/refl/common.h"
 
+#include <cstddef>
 #include <type_traits>
+#include <utility>
 
 // Provides a way to iterate over the types of members of some type.
 // This is similar to `em/refl/contains_type.h`, but provides a bit more control at the cost of longer compilation times.
@@ -111,4 +113,89 @@ namespace em::Refl
             static_assert(Meta::always_false<T>, "Unknown category!");
         }
     }
+
+    // Describes one subtype, in the same way as `VisitTypes()` reports it: `type` is the type, and `desc` is the `Visiting...` tag.
+    template <typename T, VisitDesc Desc>
+    struct ChildType
+    {
+        using type = T;
+        using desc = Desc;
+    };
+
+    namespace detail::ChildTypeLists
+    {
+        template <typename T, typename VirtualBases, typename NonVirtualBases, typename MemberIndices>
+        struct StructChildren {};
+        template <typename T, typename ...VirtualBases, typename ...NonVirtualBases, int ...I>
+        struct StructChildren<T, Meta::TypeList<VirtualBases...>, Meta::TypeList<NonVirtualBases...>, std::integer_sequence<int, I...>>
+        {
+            using type = Meta::TypeList<
+                ChildType<Meta::copy_cvref<T &&, VirtualBases>, VisitingVirtualBase>...,
+                ChildType<Meta::copy_cvref<T &&, NonVirtualBases>, VisitingDirectNonVirtualBase>...,
+                ChildType<Structs::MemberTypeCvref<T &&, I>, VisitingClassMember<I, std::remove_cvref_t<T>>>...
+            >;
+        };
+
+        template <typename T, typename AlternativeIndices>
+        struct VariantChildren {};
+        template <typename T, std::size_t ...I>
+        struct VariantChildren<T, std::index_sequence<I...>>
+        {
+            using type = Meta::TypeList<ChildType<Variants::AlternativeTypeCvref<T, I>, VisitingVariantAlternative<I>>...>;
+        };
+
+        // This mirrors `VisitTypes()`, see there.
+        template <typename T, VisitMode Mode>
+        [[nodiscard]] constexpr auto GetChildTypes()
+        {
+            constexpr Category c = classify_opt<T>;
+
+            if constexpr (c == Category::adjust)
+            {
+                return Meta::TypeList<ChildType<Adjust::AdjustedType<T &&>, VisitingOther>>{};
+            }
+            else if constexpr (c == Category::indirect)
+            {
+                return Meta::TypeList<ChildType<Indirect::ValueTypeCvref<T &&>, VisitingOther>>{};
+            }
+            else if constexpr (c == Category::structure)
+            {
+                constexpr int num_members = []{
+                    if constexpr (Structs::Type<T>)
+                        return Structs::num_members<T>;
+                    else
+                        return 0; // This can happen if the type has bases but no members.
+                }();
+
+                return typename StructChildren<
+                    T,
+                    std::conditional_t<Mode != VisitMode::base_subobject, Bases::VirtualBasesFlat<T>, Meta::TypeList<>>,
+                    Bases::NonVirtualBasesDirect<T>,
+                    std::make_integer_sequence<int, num_members>
+                >::type{};
+            }
+            else if constexpr (c == Category::range)
+            {
+                return Meta::TypeList<ChildType<Ranges::ElementTypeCvref<T>, VisitingOther>>{};
+            }
+            else if constexpr (c == Category::variant)
+            {
+                return typename VariantChildren<T, std::make_index_sequence<std::variant_size_v<std::remove_cvref_t<T>>>>::type{};
+            }
+            else if constexpr (c == Category::unknown)
+            {
+                return Meta::TypeList<>{};
+            }
+            else
+            {
+                static_assert(Meta::always_false<T>, "Unknown category!");
+            }
+        }
+    }
+
+    // A `Meta::TypeList` of `ChildType<SubT, Desc>`, one per subtype of `T`, in the same order as `VisitTypes<T, ..., Mode>()` visits them.
+    // Prefer this to `VisitTypes()` in recursive type queries. Since this is a type, it's computed only once per TU for each `T` and `Mode`,
+    //   and then shared by all the queries, regardless of the predicates.
+    template <typename T, VisitMode Mode = VisitMode::normal>
+    using ChildTypes = decltype(detail::ChildTypeLists::GetChildTypes<T, Mode>());
 }
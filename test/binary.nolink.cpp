@@ -0,0 +1,77 @@
+#include "em/refl/macros/structs.h"
+#include "em/refl/serialize/binary.h"
+
+#include <array>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <variant>
+#include <vector>
+
+EM_STRUCT(Pod)
+(
+    (int)(a)
+    (float)(b)
+    (std::array<short, 4>)(c)
+)
+
+EM_STRUCT(Padded)
+(
+    (char)(a)
+    (int)(b)
+)
+
+EM_STRUCT(ConstMember)
+(
+    (int)(a)
+    (const int)(b)
+)
+
+struct Derived : Pod {EM_REFL()};
+
+EM_STRUCT(Complex)
+(
+    (Pod)(pod)
+    (Padded)(padded)
+    (std::vector<Pod>)(pods)
+    (std::string)(str)
+    (std::optional<std::vector<int>>)(opt)
+    (std::variant<int, std::string>)(var)
+    (std::set<int>)(set)
+    (std::map<std::string, Pod>)(map)
+)
+
+static_assert(em::Refl::BulkCopyable<int>);
+static_assert(em::Refl::BulkCopyable<const int &>);
+static_assert(em::Refl::BulkCopyable<float[4][2]>);
+static_assert(em::Refl::BulkCopyable<std::array<float, 4096>>);
+static_assert(em::Refl::BulkCopyable<Pod>);
+static_assert(em::Refl::BulkCopyable<std::array<Pod, 3>>);
+static_assert(!em::Refl::BulkCopyable<int *>); // Pointers are indirect types.
+#if defined(__x86_64__) || defined(_M_X64)
+static_assert(em::Refl::BulkCopyable<long double> == (sizeof(long double) == sizeof(double))); // The x87 80-bit `long double` has padding bytes.
+#endif
+static_assert(!em::Refl::BulkCopyable<Padded>);
+static_assert(!em::Refl::BulkCopyable<std::array<Padded, 2>>);
+static_assert(!em::Refl::BulkCopyable<ConstMember>);
+static_assert(!em::Refl::BulkCopyable<Derived>);
+static_assert(!em::Refl::BulkCopyable<std::vector<int>>);
+static_assert(!em::Refl::BulkCopyable<Complex>);
+
+static_assert(em::Refl::BulkCopyableNeedsValidation<bool[2]>);
+static_assert(em::Refl::BulkCopyableNeedsValidation<std::array<bool, 2>>);
+static_assert(!em::Refl::BulkCopyableNeedsValidation<Pod>);
+
+// `pod` + `padded` (without the padding) + three range sizes + the `opt` flag + the variant index + two more range sizes.
+static_assert(em::Refl::Binary::detail::min_encoded_size<Complex> == 16 + 5 + 8 + 8 + 1 + 4 + 8 + 8);
+
+[[maybe_unused]] static void foo()
+{
+    Complex c;
+    std::vector<unsigned char> bytes = em::Refl::Binary::ToBytes(c);
+    em::Refl::Binary::FromBytes(c, bytes);
+
+    Derived d;
+    em::Refl::Binary::FromBytes(d, em::Refl::Binary::ToBytes(d));
+}
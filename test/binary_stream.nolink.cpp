@@ -0,0 +1,50 @@
+#include "em/refl/macros/structs.h"
+#include "em/refl/serialize/binary.h"
+#include "em/refl/serialize/binary_stream.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <set>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+EM_STRUCT(Pod)
+(
+    (int)(a)
+    (float)(b)
+)
+
+struct Derived : Pod {EM_REFL((std::string)(name))};
+
+EM_STRUCT(Complex)
+(
+    (Pod)(pod)
+    (Derived)(derived)
+    (std::vector<Pod>)(pods)
+    (std::optional<std::vector<int>>)(opt)
+    (std::variant<int, std::string>)(var)
+    (std::set<int>)(set)
+    (std::map<std::string, Pod>)(map)
+    (std::vector<Complex>)(children)
+)
+
+static_assert(std::is_move_constructible_v<em::Refl::Binary::StreamReader>);
+static_assert(!std::is_copy_constructible_v<em::Refl::Binary::StreamReader>);
+
+[[maybe_unused]] static void foo()
+{
+    Complex source;
+    std::vector<unsigned char> bytes = em::Refl::Binary::ToBytes(source);
+
+    // Feed the data one byte at a time.
+    Complex target;
+    em::Refl::Binary::StreamReader reader(target);
+    for (std::size_t i = 0; i < bytes.size() && !reader.Done(); i++)
+        reader.Feed(std::span(bytes).subspan(i, 1));
+    reader.Finish();
+}
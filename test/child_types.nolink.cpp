@@ -0,0 +1,62 @@
+#include "em/refl/macros/structs.h"
+#include "em/refl/visit_types.h"
+
+#include <optional>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+struct A
+{
+    EM_REFL(
+        (std::vector<int>)(a)
+        (std::variant<int, float>)(b)
+    )
+};
+
+struct B : virtual A {EM_REFL()};
+struct C {EM_REFL()};
+struct D : B, C
+{
+    EM_REFL(
+        (std::optional<int>)(c)
+    )
+};
+
+namespace
+{
+    // Checks that `ChildTypes` lists the same types and descriptions as `VisitTypes()`, in the same order.
+    template <typename T, em::Refl::VisitMode Mode = em::Refl::VisitMode::normal>
+    constexpr bool same_as_visit_types = []{
+        bool ok = true;
+        int num_visited = 0;
+        em::Refl::VisitTypes<T, em::Meta::LoopSimple, Mode>([&]<typename SubT, em::Refl::VisitDesc Desc>
+        {
+            int i = 0;
+            em::Meta::ConstForEach<em::Meta::LoopSimple>(em::Refl::ChildTypes<T, Mode>{}, [&]<typename Child>
+            {
+                if (i++ == num_visited)
+                    ok = ok && std::is_same_v<typename Child::type, SubT> && std::is_same_v<typename Child::desc, Desc>;
+            });
+            num_visited++;
+        });
+
+        int num_children = 0;
+        em::Meta::ConstForEach<em::Meta::LoopSimple>(em::Refl::ChildTypes<T, Mode>{}, [&]<typename Child>{num_children++;});
+        return ok && num_children == num_visited;
+    }();
+}
+
+static_assert(same_as_visit_types<int>);
+static_assert(same_as_visit_types<std::vector<int>>);
+static_assert(same_as_visit_types<const std::vector<int> &>);
+static_assert(same_as_visit_types<std::optional<int> &>);
+static_assert(same_as_visit_types<std::variant<int, float>>);
+static_assert(same_as_visit_types<A>);
+static_assert(same_as_visit_types<A &>);
+static_assert(same_as_visit_types<B>);
+static_assert(same_as_visit_types<C>);
+static_assert(same_as_visit_types<D>);
+static_assert(same_as_visit_types<D, em::Refl::VisitMode::base_subobject>); // No virtual bases here.
+
+static_assert(std::is_same_v<em::Refl::ChildTypes<int>, em::Meta::TypeList<>>);
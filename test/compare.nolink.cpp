@@ -0,0 +1,81 @@
+#include "em/refl/compare.h"
+#include "em/refl/macros/structs.h"
+
+#include <array>
+#include <compare>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+EM_STRUCT(Pod)
+(
+    (int)(a)
+    (int)(b)
+)
+
+EM_STRUCT(WithIgnored)
+(
+    (int)(a)
+    (int, em::Refl::CompareIgnore)(cache)
+)
+
+EM_STRUCT(Mixed)
+(
+    (int)(x)
+    (int)(y)
+    (float)(f)
+    (std::vector<Pod>)(pods)
+    (std::optional<int>)(opt)
+    (std::variant<int, std::string>)(var)
+)
+
+struct Derived : Pod
+{
+    EM_REFL(
+        (int)(c)
+    )
+};
+
+static_assert(em::Refl::BitwiseComparable<Pod>);
+static_assert(!em::Refl::BitwiseComparable<float>);
+static_assert(!em::Refl::BitwiseComparable<WithIgnored, em::Refl::CompareIgnore>);
+static_assert(em::Refl::ContiguousBitwiseComparableRange<const std::vector<Pod>>);
+
+// `x` and `y` form a run that can be compared with a single `memcmp()`. `f` can't be a part of it.
+static_assert(em::Refl::detail::Compare::member_runs<Mixed>[0] == em::Refl::detail::Compare::RunKind::start);
+static_assert(em::Refl::detail::Compare::member_runs<Mixed>[1] == em::Refl::detail::Compare::RunKind::interior);
+static_assert(em::Refl::detail::Compare::member_runs<Mixed>[2] == em::Refl::detail::Compare::RunKind::none);
+static_assert(em::Refl::detail::Compare::run_end<Mixed, 0> == 2);
+
+static_assert(em::Refl::Equal(Pod{1, 2}, Pod{1, 2}));
+static_assert(!em::Refl::Equal(Pod{1, 2}, Pod{1, 3}));
+static_assert(em::Refl::Compare(Pod{1, 2}, Pod{1, 3}) < 0);
+static_assert(em::Refl::Compare(Pod{2, 0}, Pod{1, 3}) > 0);
+
+static_assert(em::Refl::Equal(WithIgnored{1, 2}, WithIgnored{1, 3}));
+static_assert(em::Refl::Compare(WithIgnored{1, 5}, WithIgnored{1, 3}) == 0);
+
+static_assert(em::Refl::Compare(Derived{{1, 2}, 3}, Derived{{1, 2}, 4}) < 0);
+static_assert(em::Refl::Compare(Derived{{1, 3}, 3}, Derived{{1, 2}, 4}) > 0);
+
+static_assert(em::Refl::Equal(std::vector<int>{1, 2}, std::vector<int>{1, 2}));
+static_assert(!em::Refl::Equal(std::vector<int>{1, 2}, std::vector<int>{1, 2, 3}));
+static_assert(em::Refl::Compare(std::vector<int>{1, 2}, std::vector<int>{1, 2, 3}) < 0);
+static_assert(em::Refl::Compare(std::vector<int>{1, 3}, std::vector<int>{1, 2, 3}) > 0);
+
+static_assert(em::Refl::Compare(std::optional<int>{}, std::optional<int>{0}) < 0);
+static_assert(em::Refl::Equal(std::optional<int>{}, std::optional<int>{}));
+
+static_assert(em::Refl::Compare(std::variant<int, float>(1.5f), std::variant<int, float>(2)) > 0); // The index is compared first.
+static_assert(em::Refl::Compare(std::variant<int, float>(1), std::variant<int, float>(2)) < 0);
+
+static_assert(em::Refl::Equal(std::array<float, 2>{0.0f, 1}, std::array<float, 2>{-0.0f, 1}));
+static_assert(em::Refl::Compare(std::array<float, 2>{0.0f, 1}, std::array<float, 2>{0.0f, 2}) < 0);
+
+[[maybe_unused]] static void foo()
+{
+    Mixed a, b;
+    (void)em::Refl::Equal(a, b);
+    (void)em::Refl::Compare(a, b);
+}
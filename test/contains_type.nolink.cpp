@@ -34,8 +34,11 @@ namespace
     constexpr bool contains_type = []{
         constexpr bool a = em::Refl::TypeRecursivelyContainsElemCvref<T, Elem, {}, Filter>;
         constexpr bool b = (contains_type_using_visit<T, Filter>)(em::Meta::type_to_desc<Elem>);
+        // The stateful implementation, which `TypeRecursivelyContainsElemCvref` no longer uses.
+        constexpr bool c = em::Refl::TypeRecursivelyContainsPredWithStrategy<T, em::Refl::RecursiveTypeVisitorNonStatic, em::Refl::PredTypeMatchesElemCvref<Elem>, {}, Filter>;
         static_assert(a <= b);
         static_assert(a >= b);
+        static_assert(a == c);
         return b;
     }();
 }
@@ -210,3 +213,6 @@ static_assert(em::Refl::TypeRecursivelyContainsElemCvref<int &, int &>);
 static_assert(!em::Refl::TypeRecursivelyContainsElemCvref<int &, int &, em::Refl::IterationFlags::ignore_root>);
 static_assert(em::Refl::TypeRecursivelyContainsElemCvref<std::vector<int> &, int &>);
 static_assert(em::Refl::TypeRecursivelyContainsElemCvref<std::vector<int> &, int &, em::Refl::IterationFlags::ignore_root>);
+static_assert(em::Refl::TypeRecursivelyContainsElemCvref<F, float, em::Refl::IterationFlags::ignore_root>);
+static_assert(!em::Refl::TypeRecursivelyContainsElemCvref<F, F, em::Refl::IterationFlags::ignore_root>);
+static_assert(!em::Refl::TypeRecursivelyContainsElemCvref<F, float, em::Refl::IterationFlags::ignore_root, em::Meta::false_predicate>);
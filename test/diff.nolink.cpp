@@ -0,0 +1,47 @@
+#include "em/refl/diff.h"
+#include "em/refl/macros/structs.h"
+#include "em/refl/serialize/binary.h"
+
+#include <map>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+EM_STRUCT(Pod)
+(
+    (int)(a)
+    (float)(b)
+)
+
+EM_STRUCT(State)
+(
+    (Pod)(pod)
+    (std::vector<Pod>)(pods)
+    (std::vector<std::string>)(names)
+    (std::optional<Pod>)(opt)
+    (std::variant<int, Pod>)(var)
+    (std::map<std::string, int>)(map)
+    (int, em::Refl::CompareIgnore)(cache)
+)
+
+struct Derived : State
+{
+    EM_REFL(
+        (int)(extra)
+    )
+};
+
+static_assert(em::Refl::detail::Diff::ElementwiseDiffableRange<const std::vector<Pod>>);
+static_assert(!em::Refl::detail::Diff::ElementwiseDiffableRange<const std::map<std::string, int>>);
+
+[[maybe_unused]] static void foo()
+{
+    Derived a, b;
+    em::Refl::Patch patch = em::Refl::Diff(a, b);
+    em::Refl::ApplyPatch(a, patch);
+
+    // The patch itself can be serialized.
+    std::vector<unsigned char> bytes = em::Refl::Binary::ToBytes(patch);
+    em::Refl::Binary::FromBytes(patch, bytes);
+}
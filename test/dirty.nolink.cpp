@@ -0,0 +1,56 @@
+#include "em/refl/dirty.h"
+#include "em/refl/macros/structs.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+EM_STRUCT(Inner)
+(
+    EM_DIRTY_TRACKING
+    (int)(x)
+    (std::string)(name)
+)
+
+EM_STRUCT(Outer)
+(
+    EM_DIRTY_TRACKING
+    (Inner)(a)
+    (std::vector<Inner>)(b)
+    (int)(c)
+)
+
+EM_STRUCT(Untracked)
+(
+    (int)(x)
+)
+
+static_assert(em::Refl::HasDirtyTracking<Inner>);
+static_assert(em::Refl::HasDirtyTracking<const Outer &>);
+static_assert(!em::Refl::HasDirtyTracking<Untracked>);
+
+// The bits don't affect the member count.
+static_assert(em::Refl::Structs::num_members<Outer> == 3);
+
+static_assert([]{
+    Outer o;
+    (void)em::Refl::Structs::GetMemberConst<0>(o);
+    em::Refl::Structs::GetMemberMutable<2>(o) = 42;
+    return !em::Refl::IsMemberDirty<0>(o) && !em::Refl::IsMemberDirty<1>(o) && em::Refl::IsMemberDirty<2>(o);
+}());
+
+static_assert([]{
+    Outer o;
+    em::Refl::Structs::GetMemberMutable<0>(em::Refl::Structs::GetMemberMutable<0>(o)) = 1;
+    bool ok = em::Refl::IsMemberDirty<0>(o) && em::Refl::IsMemberDirty<0>(o.a) && !em::Refl::IsMemberDirty<1>(o.a);
+    em::Refl::ClearDirtyRecursively(o);
+    return ok && em::Refl::DirtyMembers(o).none() && em::Refl::DirtyMembers(o.a).none();
+}());
+
+[[maybe_unused]] static void foo()
+{
+    Outer o;
+    em::Refl::RecursivelyVisitDirtyElemsOfTypeCvref<int &>(o, [](int &){});
+    em::Refl::RecursivelyVisitDirtyElemsOfTypeCvref<const Inner &>(std::as_const(o), [](const Inner &){});
+    em::Refl::ClearDirtyRecursively(o);
+}
@@ -0,0 +1,90 @@
+#include "em/refl/compare.h"
+#include "em/refl/fingerprint.h"
+#include "em/refl/macros/structs.h"
+
+#include <array>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <variant>
+#include <vector>
+
+EM_STRUCT(Pod)
+(
+    (int)(a)
+    (float)(b)
+)
+
+EM_STRUCT(SamePod) // Only the struct name differs.
+(
+    (int)(a)
+    (float)(b)
+)
+
+EM_STRUCT(RenamedPod)
+(
+    (int)(a)
+    (float)(c)
+)
+
+EM_STRUCT(RetypedPod)
+(
+    (int)(a)
+    (double)(b)
+)
+
+EM_STRUCT(ReorderedPod)
+(
+    (float)(b)
+    (int)(a)
+)
+
+EM_STRUCT(AttributedPod)
+(
+    (int)(a)
+    (float, em::Refl::CompareIgnore)(b)
+)
+
+struct DerivedPod : Pod {EM_REFL()};
+struct DerivedSamePod : SamePod {EM_REFL()};
+
+enum class Enum : int {a, b};
+
+EM_STRUCT(Node)
+(
+    (Pod)(pod)
+    (std::vector<Node>)(children)
+    (std::optional<std::map<std::string, Node>>)(map)
+)
+
+static_assert(em::Refl::schema_fingerprint<Pod> == em::Refl::schema_fingerprint<SamePod>);
+static_assert(em::Refl::schema_fingerprint<Pod> == em::Refl::schema_fingerprint<const Pod &>);
+static_assert(em::Refl::schema_fingerprint<Pod> != em::Refl::schema_fingerprint<RenamedPod>);
+static_assert(em::Refl::schema_fingerprint<Pod> != em::Refl::schema_fingerprint<RetypedPod>);
+static_assert(em::Refl::schema_fingerprint<Pod> != em::Refl::schema_fingerprint<ReorderedPod>);
+static_assert(em::Refl::schema_fingerprint<Pod> != em::Refl::schema_fingerprint<AttributedPod>);
+
+// The base names don't matter, like the other struct names.
+static_assert(em::Refl::schema_fingerprint<DerivedPod> == em::Refl::schema_fingerprint<DerivedSamePod>);
+static_assert(em::Refl::schema_fingerprint<DerivedPod> != em::Refl::schema_fingerprint<Pod>);
+
+// Scalars are described by their kind and size, enums by their underlying type.
+static_assert(em::Refl::schema_fingerprint<int> == em::Refl::schema_fingerprint<Enum>);
+static_assert(em::Refl::schema_fingerprint<int> != em::Refl::schema_fingerprint<unsigned int>);
+static_assert(em::Refl::schema_fingerprint<int> != em::Refl::schema_fingerprint<float>);
+static_assert(em::Refl::schema_fingerprint<int> != em::Refl::schema_fingerprint<long long>);
+
+// The container types don't matter, only the elements do.
+static_assert(em::Refl::schema_fingerprint<std::vector<int>> == em::Refl::schema_fingerprint<std::set<int>>);
+static_assert(em::Refl::schema_fingerprint<std::vector<int>> != em::Refl::schema_fingerprint<std::vector<short>>);
+static_assert(em::Refl::schema_fingerprint<int[3]> != em::Refl::schema_fingerprint<int[4]>);
+static_assert(em::Refl::schema_fingerprint<std::array<int, 3>> != em::Refl::schema_fingerprint<std::array<int, 4>>);
+
+// Variant alternatives.
+static_assert(em::Refl::schema_fingerprint<std::variant<int, std::string>> != em::Refl::schema_fingerprint<std::variant<std::string, int>>);
+static_assert(em::Refl::schema_fingerprint<std::variant<int, std::string>> != em::Refl::schema_fingerprint<std::variant<int, std::string, float>>);
+static_assert(em::Refl::schema_fingerprint<std::optional<int>> != em::Refl::schema_fingerprint<std::variant<int>>);
+
+// Recursive types.
+static_assert(em::Refl::schema_fingerprint<Node> != em::Refl::schema_fingerprint<std::vector<Node>>);
@@ -0,0 +1,73 @@
+#include "em/refl/macros/structs.h"
+#include "em/refl/serialize/flat.h"
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+EM_STRUCT(Pod)
+(
+    (int)(a)
+    (float)(b)
+)
+
+EM_STRUCT(Padded)
+(
+    (char)(a)
+    (double)(b)
+    (bool)(c)
+)
+
+struct Derived : Pod
+{
+    EM_REFL(
+        (std::string)(name)
+    )
+};
+
+EM_STRUCT(Node)
+(
+    (Derived)(derived)
+    (Padded)(padded)
+    (std::vector<Pod>)(pods)
+    (std::optional<std::vector<int>>)(opt)
+    (std::variant<int, std::string>)(var)
+    (std::map<std::string, Pod>)(map)
+    (std::unique_ptr<int>)(ptr)
+    (std::vector<Node>)(children)
+)
+
+// The blocks use the natural layout.
+static_assert(em::Refl::Flat::detail::flat_size<Pod> == sizeof(Pod));
+static_assert(em::Refl::Flat::detail::flat_size<Padded> == 24);
+static_assert(em::Refl::Flat::detail::flat_size<std::string> == sizeof(em::Refl::Flat::RelSpan));
+static_assert(em::Refl::Flat::detail::flat_size<Derived> == sizeof(Pod) + sizeof(em::Refl::Flat::RelSpan));
+
+// The views expose the matching accessors.
+static_assert(std::is_same_v<decltype(em::Refl::Flat::View<Padded>{}.GetMember<0>().Value()), const char &>);
+static_assert(std::is_same_v<decltype(em::Refl::Flat::View<Pod>{}.GetMember<1>().Value()), const float &>); // `Pod` is stored as a single block, but has the same accessors.
+static_assert(std::is_same_v<decltype(em::Refl::Flat::View<Pod>{}.Value()), const Pod &>);
+static_assert(std::is_same_v<decltype(em::Refl::Flat::View<Derived>{}.GetMember<0>().AsStringView()), std::string_view>);
+static_assert(std::is_same_v<decltype(em::Refl::Flat::View<Derived>{}.GetBase<Pod>()), em::Refl::Flat::View<Pod>>);
+static_assert(std::is_same_v<decltype(em::Refl::Flat::View<Node>{}.GetMember<2>().AsSpan()), std::span<const Pod>>);
+static_assert(std::is_same_v<decltype(em::Refl::Flat::View<Node>{}.GetMember<3>().Value()[0]), em::Refl::Flat::View<int>>);
+static_assert(std::is_same_v<decltype(em::Refl::Flat::View<Node>{}.GetMember<4>().Get<1>()), em::Refl::Flat::View<std::string>>);
+static_assert(std::is_same_v<decltype(em::Refl::Flat::View<Node>{}.GetMember<7>()[0]), em::Refl::Flat::View<Node>>);
+static_assert(std::forward_iterator<decltype(em::Refl::Flat::View<Node>{}.GetMember<5>().begin())>);
+
+[[maybe_unused]] static void foo()
+{
+    Node node;
+    std::vector<unsigned char> bytes = em::Refl::Flat::ToBytes(node);
+
+    em::Refl::Flat::View<Node> view = em::Refl::Flat::MakeView<Node>(bytes);
+    for (em::Refl::Flat::View<std::pair<const std::string, Pod>> elem : view.GetMember<5>())
+        (void)elem.GetMember<0>().AsStringView();
+    if (view.GetMember<6>().HasValue())
+        (void)view.GetMember<6>().Value().Value();
+}
@@ -0,0 +1,37 @@
+#include "em/refl/recursively_visit_elems_parallel.h"
+#include "em/refl/macros/structs.h"
+
+#include <memory>
+#include <vector>
+
+EM_STRUCT(Record)
+(
+    (int)(a)
+    (std::vector<int>)(b)
+    (std::unique_ptr<int>)(c)
+)
+
+EM_STRUCT(Root)
+(
+    (std::vector<Record>)(records)
+    (int)(x)
+)
+
+[[maybe_unused]] static long long foo(const Root &root)
+{
+    return em::Refl::RecursivelyVisitElemsOfTypeCvrefParallel<const int &>(root, 0ll,
+        // Note that `int`s behind the `unique_ptr` are passed as const too.
+        [](const int &elem) -> long long {return elem;},
+        [](long long a, long long b){return a + b;},
+        {.min_chunk_size = 256}
+    );
+}
+
+// `bool` results must work too, e.g. to check if any element matches a condition.
+[[maybe_unused]] static bool bar(const Root &root)
+{
+    return em::Refl::RecursivelyVisitElemsOfTypeCvrefParallel<const int &>(root, false,
+        [](const int &elem){return elem < 0;},
+        [](bool a, bool b){return a || b;}
+    );
+}
@@ -0,0 +1,52 @@
+#include "em/refl/hash.h"
+#include "em/refl/macros/structs.h"
+
+#include <array>
+#include <map>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+EM_STRUCT(Pod)
+(
+    (int)(a)
+    (float)(b)
+)
+
+EM_STRUCT(WithIgnored)
+(
+    (int)(a)
+    (int, em::Refl::HashIgnore)(cache)
+)
+
+EM_STRUCT(Complex)
+(
+    (Pod)(pod)
+    (WithIgnored)(ignored)
+    (std::vector<Pod>)(pods)
+    (std::array<float, 4>)(arr)
+    (std::string)(str)
+    (std::optional<int>)(opt)
+    (std::variant<int, std::string>)(var)
+    (std::map<std::string, Pod>)(map)
+)
+
+static_assert(em::Refl::BulkCopyable<Pod, em::Refl::HashIgnore>);
+static_assert(em::Refl::BulkCopyable<WithIgnored>);
+static_assert(!em::Refl::BulkCopyable<WithIgnored, em::Refl::HashIgnore>); // Can't skip the ignored member in a bulk copy.
+static_assert(!em::Refl::BulkCopyable<std::array<WithIgnored, 2>, em::Refl::HashIgnore>);
+static_assert(em::Refl::ContiguousBulkRange<const std::vector<Pod>, em::Refl::HashIgnore>);
+
+[[maybe_unused]] static void foo()
+{
+    Complex c;
+    (void)em::Refl::Hash(c);
+    (void)em::Refl::Hash(c, 42);
+    (void)em::Refl::StdHash{}(c);
+
+    em::Refl::Hasher hasher;
+    em::Refl::HashAppend(hasher, c);
+    em::Refl::HashAppend(hasher, std::vector<int>{1, 2, 3});
+    (void)hasher.Digest();
+}
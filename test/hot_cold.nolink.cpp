@@ -0,0 +1,50 @@
+#include "em/refl/hot_cold.h"
+#include "em/refl/macros/structs.h"
+#include "em/refl/visit_members.h"
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+struct A
+{
+    EM_REFL(
+        EM_HOT_COLD_SPLIT
+        (int)(x)
+      EM_COLD
+        (std::string)(description)
+        (std::vector<int>)(history)
+        (int)(static count)
+      EM_HOT
+        (float)(y)
+    )
+};
+
+// The indices, names and types are the same as without the splitting.
+static_assert(em::Refl::Structs::num_members<A> == 4);
+static_assert(em::Refl::Structs::num_static_members<A> == 1);
+static_assert(em::Refl::Structs::GetMemberName<A>(1) == "description");
+static_assert(em::Refl::Structs::GetMemberName<A>(3) == "y");
+static_assert(std::is_same_v<em::Refl::Structs::MemberType<A, 2>, std::vector<int>>);
+static_assert(std::is_same_v<em::Refl::Structs::MemberTypeCvref<A &, 1>, std::string &>);
+static_assert(std::is_same_v<em::Refl::Structs::MemberTypeCvref<const A &, 1>, const std::string &>);
+static_assert(std::is_same_v<em::Refl::Structs::MemberTypeCvref<A &&, 1>, std::string &&>);
+
+static_assert(!em::Refl::Structs::member_has_attribute<A, 0, em::Refl::Cold>);
+static_assert(em::Refl::Structs::member_has_attribute<A, 1, em::Refl::Cold>);
+static_assert(em::Refl::Structs::member_has_attribute<A, 2, em::Refl::Cold>);
+static_assert(!em::Refl::Structs::member_has_attribute<A, 3, em::Refl::Cold>);
+
+// The cold members are behind a pointer.
+static_assert(sizeof(A) < sizeof(std::string));
+static_assert(!em::Refl::Structs::HasMemberLayout<A>);
+
+[[maybe_unused]] static void foo()
+{
+    A a;
+    em::Refl::Structs::GetMemberMutable<1>(a) = "foo";
+    A b = a;
+    (void)em::Refl::Structs::GetMemberConst<2>(std::as_const(b)).size();
+    (void)em::Refl::VisitMembers<em::Meta::LoopSimple>(std::move(b), []<em::Refl::VisitDesc Desc>(auto &&){});
+}
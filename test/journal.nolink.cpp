@@ -0,0 +1,41 @@
+#include "em/refl/journal.h"
+#include "em/refl/macros/structs.h"
+
+#include <string>
+#include <vector>
+
+EM_STRUCT(Doc)
+(
+    (int)(x)
+    (std::string)(name)
+    (std::vector<int>)(values)
+)
+
+[[maybe_unused]] static void foo()
+{
+    Doc doc;
+    em::Refl::Journal journal;
+
+    journal.GetMemberMutable<0>(doc) = 42;
+    journal.GetMemberMutable<1>(doc) = "foo";
+    journal.Commit();
+
+    journal.Record(doc.values);
+    doc.values.push_back(1);
+    journal.Commit();
+
+    // Recording the whole object after one of its members saves it too.
+    journal.Record(doc.x);
+    journal.Record(doc);
+    journal.Commit();
+
+    // Same for the parts owned through pointers.
+    journal.Record(doc.values[0]);
+    doc.values[0] = 2;
+    journal.Record(doc);
+    journal.Commit();
+
+    journal.Undo();
+    journal.Redo();
+    (void)journal.MemoryUsage();
+}
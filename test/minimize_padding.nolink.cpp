@@ -0,0 +1,63 @@
+#include "em/refl/macros/structs.h"
+#include "em/refl/minimize_padding.h"
+#include "em/refl/visit_members.h"
+
+#include <cstdint>
+#include <map>
+#include <type_traits>
+#include <utility>
+
+struct A
+{
+    EM_REFL(
+        EM_MINIMIZE_PADDING
+        (char)(a)
+        (double)(b, 1.5)
+        (std::int16_t)(c,)
+        (int)(static count)
+        (std::map<int, int>)(d)
+        (char)(e)
+    )
+};
+
+struct A_Unsorted
+{
+    char a;
+    double b;
+    std::int16_t c;
+    std::map<int, int> d;
+    char e;
+};
+
+struct A_Sorted
+{
+    std::map<int, int> d;
+    double b;
+    std::int16_t c;
+    char a;
+    char e;
+};
+
+// The indices, names and types are the same as without the reordering.
+static_assert(em::Refl::Structs::num_members<A> == 5);
+static_assert(em::Refl::Structs::num_static_members<A> == 1);
+static_assert(em::Refl::Structs::GetMemberName<A>(0) == "a");
+static_assert(em::Refl::Structs::GetMemberName<A>(4) == "e");
+static_assert(std::is_same_v<em::Refl::Structs::MemberType<A, 3>, std::map<int, int>>);
+static_assert(std::is_same_v<em::Refl::Structs::MemberTypeCvref<A &, 1>, double &>);
+static_assert(std::is_same_v<em::Refl::Structs::MemberTypeCvref<const A &, 1>, const double &>);
+static_assert(std::is_same_v<em::Refl::Structs::MemberTypeCvref<A &&, 1>, double &&>);
+
+// But the padding is gone.
+static_assert(sizeof(A) < sizeof(A_Unsorted));
+static_assert(sizeof(A) == sizeof(A_Sorted));
+static_assert(!em::Refl::Structs::HasMemberLayout<A>);
+
+[[maybe_unused]] static void foo()
+{
+    A a;
+    em::Refl::Structs::GetMemberMutable<2>(a) = 42;
+    A b = a;
+    (void)em::Refl::Structs::GetMemberConst<3>(std::as_const(b)).size();
+    (void)em::Refl::VisitMembers<em::Meta::LoopSimple>(std::move(b), []<em::Refl::VisitDesc Desc>(auto &&){});
+}
@@ -0,0 +1,46 @@
+// Checks that `em/refl/module.cppm` works. Unlike the other tests, this needs the BMI of `em.refl`, see that file for how to build it (and for why it is experimental).
+// Remember that `em/meta` isn't exported from the module, so we include what we need from it.
+
+#include "em/meta/const_for.h"
+#include "em/refl/macros.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+import em.refl;
+
+struct A
+{
+    EM_REFL(
+        (int)(x)
+        (std::vector<float>)(y)
+        (std::optional<std::string>)(z)
+    )
+};
+
+struct B
+{
+    EM_REFL(
+        EM_DIRTY_TRACKING
+        (A)(a)
+        (std::vector<A>)(as)
+    )
+};
+
+static_assert(em::Refl::Structs::num_members<A> == 3);
+static_assert(em::Refl::Structs::GetMemberName<A>(1) == "y");
+static_assert(em::Refl::TypeRecursivelyContainsElemCvref<B &, float &>);
+static_assert(!em::Refl::TypeRecursivelyContainsElemCvref<B &, double &>);
+static_assert(em::Refl::schema_fingerprint<A> != em::Refl::schema_fingerprint<B>);
+
+[[maybe_unused]] static void foo()
+{
+    B b;
+    em::Refl::RecursivelyVisitElemsOfTypeCvref<float &>(b, [](float &f){f++;});
+    em::Refl::VisitMembers<em::Meta::LoopSimple>(b.a, []<em::Refl::VisitDesc Desc>(auto &&){});
+    (void)em::Refl::IsMemberDirty<0>(b);
+    (void)em::Refl::Equal(b, B{});
+    (void)em::Refl::Hash(b);
+    (void)em::Refl::Binary::ToBytes(b);
+}
@@ -0,0 +1,58 @@
+#include "em/refl/macros/structs.h"
+#include "em/refl/soa_vector.h"
+#include "em/refl/visit_members.h"
+
+#include <string>
+#include <type_traits>
+#include <utility>
+
+EM_STRUCT(Particle)
+(
+    (float)(x)
+    (float)(y)
+    (int)(id)
+    (std::string)(name)
+)
+
+using Ref = em::Refl::SoaVector<Particle>::reference;
+using ConstRef = em::Refl::SoaVector<Particle>::const_reference;
+
+// The proxies are reflected like the original struct.
+static_assert(em::Refl::Structs::num_members<Ref> == 4);
+static_assert(em::Refl::Structs::GetMemberName<ConstRef>(2) == "id");
+static_assert(std::is_same_v<em::Refl::Structs::MemberTypeCvref<Ref, 0>, float &>);
+static_assert(std::is_same_v<em::Refl::Structs::MemberTypeCvref<ConstRef, 0>, const float &>);
+static_assert(std::is_same_v<decltype(em::Refl::Structs::GetMemberConst<1>(std::declval<Ref>())), const float &>);
+
+static_assert([]{
+    em::Refl::SoaVector<Particle> v;
+    Particle p;
+    p.x = 1;
+    p.id = 3;
+    v.push_back(p);
+    p.x = 4;
+    p.id = 6;
+    v.push_back(std::move(p));
+
+    float sum = 0;
+    for (float x : v.Column<0>())
+        sum += x;
+
+    int num_members = 0;
+    (void)em::Refl::VisitMembers<em::Meta::LoopSimple>(v[1], [&]<em::Refl::VisitDesc Desc>(auto &&){num_members++;});
+
+    v[0] = v[1];
+    Particle q = v[0];
+
+    return v.size() == 2 && sum == 5 && num_members == 4 && q.id == 6;
+}());
+
+[[maybe_unused]] static void foo()
+{
+    em::Refl::SoaVector<Particle> v;
+    v.reserve(10);
+    v.resize(5);
+    v[2] = Particle{};
+    v.pop_back();
+    v.clear();
+}
@@ -20,3 +20,14 @@ struct B : A
 {
     EM_REFL()
 };
+
+[[maybe_unused]] static void foo()
+{
+    const auto &map = em::Refl::StaticVirtual::GetFrozenMap<A::MyIn>();
+    if (const A::MyIn *impl = map.Find("B"))
+        (void)impl->f1(42);
+    (void)map.At("A").f1(43);
+
+    int id = em::Refl::StaticVirtual::IdOf<A::MyIn, B>();
+    (void)map.AtId(id).f1(44);
+}
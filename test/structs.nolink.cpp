@@ -49,6 +49,51 @@ static_assert(em::Refl::Structs::HasMemberNames<A>);
 static_assert(em::Refl::Structs::HasMemberNames<const volatile A &&>);
 static_assert(em::Refl::Structs::GetMemberName<A>(0) == "x");
 static_assert(em::Refl::Structs::GetMemberName<const volatile A &&>(1) == "y");
+static_assert(em::Refl::Structs::FindMemberByName<A>("x") == 0);
+static_assert(em::Refl::Structs::FindMemberByName<const volatile A &&>("y") == 1);
+static_assert(em::Refl::Structs::FindMemberByName<A>("z") == -1);
+static_assert(em::Refl::Structs::FindMemberByName<A>("") == -1);
+
+// A wide struct, so that the perfect hash has buckets with several names and needs to search for the seeds.
+struct Wide
+{
+    EM_REFL(
+        (int)(m0) (int)(m1) (int)(m2) (int)(m3) (int)(m4) (int)(m5) (int)(m6) (int)(m7) (int)(m8) (int)(m9)
+        (int)(m10) (int)(m11) (int)(m12) (int)(m13) (int)(m14) (int)(m15) (int)(m16) (int)(m17) (int)(m18) (int)(m19)
+        (int)(m20) (int)(m21) (int)(m22) (int)(m23) (int)(m24) (int)(m25) (int)(m26) (int)(m27) (int)(m28) (int)(m29)
+        (int)(m30) (int)(m31) (int)(m32) (int)(m33) (int)(m34) (int)(m35) (int)(m36) (int)(m37) (int)(m38) (int)(m39)
+        (int)(m40) (int)(m41) (int)(m42) (int)(m43) (int)(m44) (int)(m45) (int)(m46) (int)(m47) (int)(m48) (int)(m49)
+        (int)(m50) (int)(m51) (int)(m52) (int)(m53) (int)(m54) (int)(m55) (int)(m56) (int)(m57) (int)(m58) (int)(m59)
+        (int)(m60) (int)(m61) (int)(m62) (int)(m63) (int)(m64) (int)(m65) (int)(m66) (int)(m67) (int)(m68) (int)(m69)
+        (int)(m70) (int)(m71) (int)(m72) (int)(m73) (int)(m74) (int)(m75) (int)(m76) (int)(m77) (int)(m78) (int)(m79)
+        (int)(m80) (int)(m81) (int)(m82) (int)(m83) (int)(m84) (int)(m85) (int)(m86) (int)(m87) (int)(m88) (int)(m89)
+        (int)(m90) (int)(m91) (int)(m92) (int)(m93) (int)(m94) (int)(m95) (int)(m96) (int)(m97) (int)(m98) (int)(m99)
+        (int)(m100) (int)(m101) (int)(m102) (int)(m103) (int)(m104) (int)(m105) (int)(m106) (int)(m107) (int)(m108) (int)(m109)
+        (int)(m110) (int)(m111) (int)(m112) (int)(m113) (int)(m114) (int)(m115) (int)(m116) (int)(m117) (int)(m118) (int)(m119)
+        (int)(m120) (int)(m121) (int)(m122) (int)(m123) (int)(m124) (int)(m125) (int)(m126) (int)(m127) (int)(m128) (int)(m129)
+        (int)(m130) (int)(m131) (int)(m132) (int)(m133) (int)(m134) (int)(m135) (int)(m136) (int)(m137) (int)(m138) (int)(m139)
+        (int)(m140) (int)(m141) (int)(m142) (int)(m143) (int)(m144) (int)(m145) (int)(m146) (int)(m147) (int)(m148) (int)(m149)
+        (int)(m150) (int)(m151) (int)(m152) (int)(m153) (int)(m154) (int)(m155) (int)(m156) (int)(m157) (int)(m158) (int)(m159)
+        (int)(m160) (int)(m161) (int)(m162) (int)(m163) (int)(m164) (int)(m165) (int)(m166) (int)(m167) (int)(m168) (int)(m169)
+        (int)(m170) (int)(m171) (int)(m172) (int)(m173) (int)(m174) (int)(m175) (int)(m176) (int)(m177) (int)(m178) (int)(m179)
+        (int)(m180) (int)(m181) (int)(m182) (int)(m183) (int)(m184) (int)(m185) (int)(m186) (int)(m187) (int)(m188) (int)(m189)
+        (int)(m190) (int)(m191) (int)(m192) (int)(m193) (int)(m194) (int)(m195) (int)(m196) (int)(m197) (int)(m198) (int)(m199)
+    )
+};
+static_assert(em::Refl::Structs::num_members<Wide> == 200);
+static_assert([]{
+    for (int i = 0; i < em::Refl::Structs::num_members<Wide>; i++)
+    {
+        if (em::Refl::Structs::FindMemberByName<Wide>(em::Refl::Structs::GetMemberName<Wide>(i)) != i)
+            return false;
+    }
+    return true;
+}());
+static_assert(em::Refl::Structs::FindMemberByName<Wide>("m200") == -1);
+static_assert(em::Refl::Structs::FindMemberByName<Wide>("m") == -1);
+static_assert(em::Refl::Structs::FindMemberByName<Wide>("M0") == -1);
+static_assert(em::Refl::Structs::FindMemberByName<Wide>("m0 ") == -1);
+static_assert(em::Refl::Structs::FindMemberByName<Wide>("") == -1);
 
 struct A1 : em::Refl::BasicAttribute {};
 struct A2 : em::Refl::BasicAttribute {};
@@ -160,6 +205,10 @@ static_assert(std::is_same_v<em::Refl::Structs::StaticMemberTypeCvrefMutable<con
 
 static_assert(em::Refl::Structs::GetStaticMemberName<B>(0) == "x");
 static_assert(em::Refl::Structs::GetStaticMemberName<const volatile B &&>(1) == "y");
+static_assert(em::Refl::Structs::FindStaticMemberByName<B>("x") == 0);
+static_assert(em::Refl::Structs::FindStaticMemberByName<const volatile B &&>("y") == 1);
+static_assert(em::Refl::Structs::FindStaticMemberByName<B>("z") == -1);
+static_assert(em::Refl::Structs::FindStaticMemberByName<A>("x") == -1); // No static members.
 
 struct StaticAttrs
 {
@@ -186,6 +235,42 @@ static_assert(std::is_same_v<em::Refl::Structs::StaticMemberFindAttribute<Static
 static_assert(std::is_same_v<em::Refl::Structs::StaticMemberFindAttribute<StaticAttrs, 3, A2>, A2_>);
 
 
+// Member layout!
+
+EM_STRUCT( Layout )
+(
+    (char)(a)
+    (const int)(b)
+    (double)(c)
+)
+
+static_assert(em::Refl::Structs::HasMemberLayout<Layout>);
+static_assert(em::Refl::Structs::HasMemberLayout<const volatile Layout &&>);
+static_assert(em::Refl::Structs::MemberLayout<Layout>().size() == 3);
+static_assert(em::Refl::Structs::MemberLayout<Layout>()[0].offset == offsetof(Layout, a));
+static_assert(em::Refl::Structs::MemberLayout<Layout>()[1].offset == offsetof(Layout, b));
+static_assert(em::Refl::Structs::MemberLayout<Layout>()[2].offset == offsetof(Layout, c));
+static_assert(em::Refl::Structs::MemberLayout<Layout>()[1].size == sizeof(int));
+static_assert(em::Refl::Structs::MemberLayout<Layout>()[2].alignment == alignof(double));
+static_assert(em::Refl::Structs::MemberLayout<Layout>()[1].type_id == em::Refl::type_id<int>);
+static_assert(em::Refl::Structs::MemberLayout<Layout>()[2].type_id != em::Refl::type_id<int>);
+static_assert(em::Refl::Structs::HasMemberLayout<Empty>);
+static_assert(em::Refl::Structs::MemberLayout<Empty>().empty());
+
+static_assert(!em::Refl::Structs::HasMemberLayout<Attrs>); // Has a reference member.
+static_assert(!em::Refl::Structs::HasMemberLayout<std::tuple<int, float>>); // Tuples don't provide this.
+
+struct NonStandardLayout
+{
+    EM_REFL(
+        (int)(x)
+      EM_PRIVATE
+        (int)(y)
+    )
+};
+static_assert(!em::Refl::Structs::HasMemberLayout<NonStandardLayout>);
+
+
 // Propagating cvref.
 
 EM_STRUCT( Cvref )
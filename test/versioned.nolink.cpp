@@ -0,0 +1,71 @@
+#include "em/refl/macros/structs.h"
+#include "em/refl/serialize/versioned.h"
+
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace V1
+{
+    EM_STRUCT(Pod)
+    (
+        (int)(a)
+        (short)(b)
+    )
+
+    EM_STRUCT(Doc)
+    (
+        (std::string)(name)
+        (std::vector<Pod>)(pods)
+        (std::set<int>)(ids)
+        (std::optional<Pod>)(opt)
+        (std::variant<int, std::string>)(var)
+        (int)(removed)
+        (std::vector<Doc>)(children)
+    )
+}
+
+namespace V2
+{
+    enum class Color : unsigned char {red, green};
+
+    EM_STRUCT(Pod)
+    (
+        (double)(b)
+        (long long)(a)
+        (Color)(color, Color::green)
+    )
+
+    EM_STRUCT(Doc)
+    (
+        (std::vector<Pod>)(pods)
+        (std::string)(name)
+        (std::vector<long>)(ids)
+        (std::optional<Pod>)(opt)
+        (std::variant<long, std::string, float>)(var)
+        (std::map<std::string, int>)(added)
+        (std::vector<Doc>)(children)
+    )
+}
+
+static_assert(em::Refl::schema_fingerprint<V1::Doc> != em::Refl::schema_fingerprint<V2::Doc>);
+
+[[maybe_unused]] static void foo()
+{
+    V1::Doc old_doc;
+    std::vector<unsigned char> bytes = em::Refl::Versioned::ToBytes(old_doc);
+
+    // The same type, this reads the data directly.
+    em::Refl::Versioned::FromBytes(old_doc, bytes);
+
+    // A different version, this converts the data.
+    V2::Doc new_doc;
+    em::Refl::Versioned::FromBytes(new_doc, bytes);
+    em::Refl::Versioned::FromBytes(old_doc, em::Refl::Versioned::ToBytes(new_doc));
+
+    em::Refl::Versioned::Schema schema = em::Refl::Versioned::MakeSchema<V2::Doc>();
+    (void)schema;
+}
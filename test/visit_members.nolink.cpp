@@ -19,3 +19,11 @@ struct D : B, C {EM_REFL()};
     // Just a minimal sanity check.
     em::Refl::VisitMembers<em::Meta::LoopSimple>(D{}, []<em::Refl::VisitDesc Desc>(auto &&){});
 }
+
+// Only the active variant alternative is visited.
+static_assert([]{
+    std::variant<int, float, char> var = 2.5f;
+    int visited = 0;
+    em::Refl::VisitMembers<em::Meta::LoopSimple>(var, [&]<em::Refl::VisitDesc Desc>(auto &&){visited = visited * 10 + Desc::value + 1;});
+    return visited == 2;
+}());